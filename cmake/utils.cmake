@@ -71,3 +71,19 @@ macro(add_game_test TARGET)
     target_link_libraries(${TARGET} game-tester)
 endmacro()
 
+macro(add_game_simulation TARGET)
+    add_executable(${TARGET} ${ARGN})
+    set_target_properties(${TARGET} PROPERTIES CXX_STANDARD 17 CXX_STANDARD_REQUIRED ON)
+    target_compile_definitions(${TARGET} PUBLIC GAME_SDK_NATIVE NOABI)
+    # eosio.cdt attributes are unknown for host compiler
+    target_compile_options(${TARGET} PUBLIC
+        $<$<CXX_COMPILER_ID:Clang>:-Wno-unknown-attributes>
+        $<$<CXX_COMPILER_ID:GNU>:-Wno-attributes>
+    )
+
+    if(IS_DEBUG)
+        target_compile_options(${TARGET} PUBLIC -DIS_DEBUG=on)
+    endif()
+
+    target_link_libraries(${TARGET} game-simulator)
+endmacro()
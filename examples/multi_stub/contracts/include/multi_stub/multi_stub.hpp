@@ -20,6 +20,17 @@ class [[eosio::contract]] multi_stub : public game_sdk::game {
     };
     using roll_table = eosio::multi_index<"roll"_n, roll_row>;
 
+    /* game's own event, sent when next action is required */
+    struct action_progress {
+        static constexpr uint32_t type{game_sdk::first_custom_event_type};
+
+        uint64_t action;
+        uint64_t total;
+        EOSLIB_SERIALIZE(action_progress, (action)(total))
+    };
+
+    using game_events = events::registry::with<action_progress>;
+
   public:
     multi_stub(name receiver, name code, eosio::datastream<const char*> ds)
         : game(receiver, code, ds), rolls(_self, _self.value) {}
@@ -43,10 +43,12 @@ void multi_stub::on_random(session_id_t ses_id, checksum256 rand) {
     const auto current_action = it->event_numbers.size();
     if (current_action < it->event_numbers[0]) {
         eosio::print("Current action: ", current_action, "\n");
+        send_event<game_events>(action_progress{current_action, it->event_numbers[0]});
         require_action(current_action);
     } else {
         eosio::print("Finish game at action: ", current_action, "\n");
-        finish_game(zero_asset, it->event_numbers);
+        // long vector of actions params is sent in compact encoding
+        finish_game(zero_asset, service::compact::encode(it->event_numbers));
     }
 }
 
@@ -1,10 +1,27 @@
+#include <game_tester/compact.hpp>
 #include <game_tester/game_tester.hpp>
 #include <vector>
 
+#include <boost/filesystem.hpp>
+
 #include "contracts.hpp"
 
 namespace testing {
 
+/* multi_stub::multi_stub::action_progress */
+struct action_progress {
+    static constexpr uint32_t type{game_sdk::first_custom_event_type};
+
+    uint64_t action;
+    uint64_t total;
+};
+
+} // namespace testing
+
+FC_REFLECT(testing::action_progress, (action)(total))
+
+namespace testing {
+
 class stub_tester : public game_tester {
   public:
     static const name game_name;
@@ -16,6 +33,7 @@ class stub_tester : public game_tester {
 
         game_params_type game_params = {};
         deploy_game<multi_stub_game>(game_name, game_params);
+        register_event<action_progress>();
     }
 };
 
@@ -98,6 +116,19 @@ BOOST_FIXTURE_TEST_CASE(full_session_actions_success_test, stub_tester) try {
         const auto msg_event = get_events(events_id::game_message); // Event with random number
         BOOST_REQUIRE(msg_event != std::nullopt);
         BOOST_REQUIRE_EQUAL(msg_event->size(), 1);
+
+        if (index + 1 != count) {
+            const auto progress = get_events_typed<action_progress>();
+            BOOST_REQUIRE(progress != std::nullopt);
+            BOOST_REQUIRE_EQUAL(progress->size(), 1);
+            BOOST_REQUIRE_EQUAL(progress->at(0).action, index + 1);
+            BOOST_REQUIRE_EQUAL(progress->at(0).total, count);
+
+            // custom events are decoded to variants as well
+            const auto progress_event = get_events(static_cast<events_id>(action_progress::type));
+            BOOST_REQUIRE(progress_event != std::nullopt);
+            BOOST_REQUIRE_EQUAL(progress_event.value()[0]["action"].as<uint64_t>(), index + 1);
+        }
     }
 
     const auto session = get_game_session(game_name, ses_id);
@@ -106,11 +137,53 @@ BOOST_FIXTURE_TEST_CASE(full_session_actions_success_test, stub_tester) try {
     const auto finish_event = get_events(events_id::game_finished);
     BOOST_REQUIRE(finish_event != std::nullopt); // Can't find finish game event.
     BOOST_REQUIRE_EQUAL(finish_event->size(), 1);
-    const auto values = fc::raw::unpack<std::vector<uint64_t>>(finish_event.value()[0]["msg"].as<bytes>());
+    const auto msg = finish_event.value()[0]["msg"].as<bytes>();
+    BOOST_REQUIRE_LT(msg.size(), sizeof(uint64_t) * expected.size());
+    const auto values = compact::decode(msg);
     BOOST_CHECK_EQUAL_COLLECTIONS(expected.begin(), expected.end(), values.begin(), values.end());
 }
 FC_LOG_AND_RETHROW()
 
+// workload recorded once is replayed on fresh fixture with the same results
+BOOST_AUTO_TEST_CASE(journal_replay_test) try {
+    const auto path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    const auto player_name = N(player);
+    const auto game_name = stub_tester::game_name;
+    {
+        action_journal journal(path);
+        stub_tester tester;
+        tester.set_journal(&journal);
+        tester.begin_journal_segment("workload");
+
+        tester.create_player(player_name);
+        tester.link_game(player_name, game_name);
+        tester.transfer(N(eosio), player_name, STRSYM("10.0000"));
+        tester.transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+        const auto ses_id = tester.new_game_session(game_name, player_name, stub_tester::casino_id, STRSYM("5.0000"));
+        tester.game_action(game_name, ses_id, 0, {3});
+        tester.signidice(game_name, ses_id);
+        for (auto index = 1; index != 3; ++index) {
+            tester.game_action(game_name, ses_id, index, {uint64_t(rand())});
+            tester.signidice(game_name, ses_id);
+        }
+        // failed action is journaled too
+        BOOST_REQUIRE_EQUAL(tester.push_action(game_name,
+                                               N(gameaction),
+                                               {platform_name, N(gameaction)},
+                                               mvo()("req_id", ses_id)("type", 0)("params", std::vector<param_t>{1})),
+                            tester.wasm_assert_msg("session with this ses_id not found"));
+    }
+
+    const auto diff = replay_journal<stub_tester>(path);
+    boost::filesystem::remove(path);
+
+    BOOST_REQUIRE_EQUAL(diff.replayed, 14);
+    // CPU of the same contract is compared with wide margin to tolerate noisy runners
+    BOOST_REQUIRE_JOURNAL_MATCH(diff, 1000.);
+}
+FC_LOG_AND_RETHROW()
+
 BOOST_FIXTURE_TEST_CASE(new_session_affl_test, stub_tester) try {
     auto player_name = N(player);
 
@@ -0,0 +1,66 @@
+#include <game_simulator/explorer.hpp>
+
+#include <odd_or_even/odd_or_even.hpp>
+
+#include <chrono>
+#include <iostream>
+
+/*
+ Exact RTP of odd_or_even strategies, computed by exhaustive exploration.
+ Usage: odd_or_even_exploration [workers]
+*/
+
+using game_sim::player_action;
+using request_t = game_sim::events::action_request;
+
+int main(int argc, char** argv) try {
+    game_sim::explore_config config;
+    if (argc > 1) {
+        config.workers = std::stoul(argv[1]);
+    }
+
+    const auto bet = eosio::asset(10'0000, game_sdk::game::core_symbol);
+
+    // every round after the first one requires deposit before bet
+    const auto bet_action = [&](const request_t& request) {
+        return request.need_deposit ? player_action{odd_or_even::action::bet, {}, bet}
+                                    : player_action{odd_or_even::action::bet, {}};
+    };
+    const auto take_action = player_action{odd_or_even::action::take, {}};
+
+    const std::vector<std::pair<std::string, game_sim::decisions_t>> strategies = {
+        {"take", [&](const request_t&) { return std::vector<player_action>{take_action}; }},
+        {"always bet", [&](const request_t& request) { return std::vector<player_action>{bet_action(request)}; }},
+        {"optimal",
+         [&](const request_t& request) {
+             return std::vector<player_action>{bet_action(request), take_action};
+         }},
+    };
+
+    // game takes parity of `cut_to<param_t>(digest)`
+    const game_sim::random_model_t random = []() { return game_sim::cut_to_buckets(2u); };
+
+    const game_sim::simulator_factory_t factory = [](uint64_t seed) {
+        return std::make_unique<game_sim::simulator>("oddoreven"_n, game_sdk::game_params_type{}, seed);
+    };
+
+    for (const auto& [strategy, decisions] : strategies) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto result = game_sim::explore(factory, bet, decisions, random, config);
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << strategy << ": rtp " << result.rtp() << ", states " << result.states << ", memo hits "
+                  << result.memo_hits << ", " << elapsed << " sec" << std::endl;
+
+        // taking deposit back at once is always fair
+        if (strategy == "take" && result.rtp() != 1.) {
+            std::cerr << "unexpected rtp of 'take' strategy" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+} catch (const std::exception& e) {
+    std::cerr << "exploration failed: " << e.what() << std::endl;
+    return 1;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <game-contract-sdk/game_base.hpp>
+#include <game-contract-sdk/recycled_table.hpp>
 
 namespace proto_dice {
 
@@ -20,15 +21,22 @@ class [[eosio::contract]] proto_dice : public game_sdk::game {
     static constexpr uint16_t max_payout_param_type = 2;
 
     static constexpr uint8_t roll_action_type = 0;
+    // continuous mode: rounds are played from session balance until cash out
+    static constexpr uint8_t round_action_type = 1;
+    static constexpr uint8_t cash_out_action_type = 2;
 
   public:
+    // rows of finished sessions are reused, dice sessions are short and frequent
     struct [[eosio::table("roll")]] roll_row {
+        uint64_t slot;
         uint64_t ses_id;
         uint32_t number;
+        uint64_t stake; // <- bet of continuous round, zero for single roll
 
-        uint64_t primary_key() const { return ses_id; }
+        uint64_t primary_key() const { return slot; }
+        uint64_t by_ses_id() const { return ses_id; }
     };
-    using roll_table = eosio::multi_index<"roll"_n, roll_row>;
+    using roll_table = game_sdk::recycled_table<"roll"_n, roll_row>;
 
   public:
     proto_dice(name receiver, name code, eosio::datastream<const char*> ds)
@@ -46,6 +54,9 @@ class [[eosio::contract]] proto_dice : public game_sdk::game {
     void check_params(uint64_t ses_id);
     void check_bet(uint64_t ses_id);
     asset calc_max_win(uint64_t ses_id, game_sdk::param_t num);
+    asset calc_round_win(uint64_t ses_id, game_sdk::param_t num, asset stake);
+    void check_number(game_sdk::param_t num);
+    void save_roll(uint64_t ses_id, game_sdk::param_t num, uint64_t stake);
 
   private:
     roll_table rolls;
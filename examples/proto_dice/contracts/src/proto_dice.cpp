@@ -30,6 +30,33 @@ asset proto_dice::calc_max_win(uint64_t ses_id, game_sdk::param_t num) {
     return max_profit / win_chance + session.deposit;
 }
 
+// fair odds of winning `num`, player's profit is limited by max payout param
+asset proto_dice::calc_round_win(uint64_t ses_id, game_sdk::param_t num, asset stake) {
+    const auto max_profit = asset(*get_param_value(ses_id, max_payout_param_type), core_symbol);
+    const auto win_chance = 99 - num;
+
+    return std::min(stake * (100 - win_chance) / win_chance, max_profit);
+}
+
+void proto_dice::check_number(game_sdk::param_t num) {
+    eosio::print("player number: ", num, "\n");
+    eosio::check(num > 0, "number should be more than 0");
+    eosio::check(num < 99, "number should be less than 99");
+}
+
+void proto_dice::save_roll(uint64_t ses_id, game_sdk::param_t num, uint64_t stake) {
+    const auto updater = [&](auto& row) {
+        row.number = uint32_t(num);
+        row.stake = stake;
+    };
+
+    if (const auto* roll = rolls.find(ses_id)) {
+        rolls.modify(*roll, get_self(), updater);
+    } else {
+        rolls.emplace(get_self(), ses_id, updater);
+    }
+}
+
 void proto_dice::on_new_game(uint64_t ses_id) {
     check_params(ses_id);
     check_bet(ses_id);
@@ -38,16 +65,37 @@ void proto_dice::on_new_game(uint64_t ses_id) {
 }
 
 void proto_dice::on_action(uint64_t ses_id, uint16_t type, std::vector<game_sdk::param_t> params) {
+    if (type == cash_out_action_type) {
+        eosio::check(rolls.find(ses_id) != nullptr, "cash out is allowed after round only");
+        return cash_out();
+    }
+
+    if (type == round_action_type) {
+        eosio::check(params.size() == 2, "params amount should be 2");
+        check_number(params[0]);
+
+        const auto balance = get_session_balance(ses_id);
+        const auto stake = asset(params[1], balance.symbol);
+        eosio::check(stake.amount > 0 && stake <= balance, "stake should be within session balance");
+
+        save_roll(ses_id, params[0], params[1]);
+        // player behind deposit doesn't release casino's lock below zero
+        update_max_win(std::max(balance + calc_round_win(ses_id, params[0], stake), get_session(ses_id).deposit));
+        return require_random();
+    }
+
+    // continuous session is settled by rounds, single roll would pay against whole deposit
+    const auto* roll = rolls.find(ses_id);
+    eosio::check(!has_rounds(ses_id) && (roll == nullptr || roll->stake == 0),
+                 "only round and cash out actions are allowed in continuous session");
+
     eosio::check(type == roll_action_type, "allowed only roll action with type 0");
     eosio::check(params.size() == 1, "params amount should be 1");
     eosio::print("player number: ", params[0], "\n");
     eosio::check(params[0] > 0, "number should be more than 0");
     eosio::check(params[0] < 100, "number should be less than 100");
 
-    rolls.emplace(get_self(), [&](auto& row) {
-        row.ses_id = ses_id;
-        row.number = uint32_t(params[0]);
-    });
+    save_roll(ses_id, params[0], 0u);
 
     update_max_win(calc_max_win(ses_id, params[0]));
 
@@ -57,10 +105,19 @@ void proto_dice::on_action(uint64_t ses_id, uint16_t type, std::vector<game_sdk:
 void proto_dice::on_random(uint64_t ses_id, checksum256 rand) {
     const auto& roll = rolls.get(ses_id);
     const auto& session = get_session(ses_id);
-    const auto rand_number = service::cut_to<uint32_t>(rand) % 100;
+    const auto rand_number = service::uniform<100>(rand);
 
     eosio::print("rand num: ", rand_number, "\n");
 
+    if (roll.stake != 0) {
+        const auto stake = asset(roll.stake, session.deposit.symbol);
+        const auto round_win = roll.number >= rand_number ? -stake : calc_round_win(ses_id, roll.number, stake);
+        settle_round(round_win, std::vector<game_sdk::param_t>{rand_number});
+        require_action(round_action_type);
+        // next round's random is signed by platform while player makes bet
+        return prefetch_random();
+    }
+
     if (roll.number >= rand_number) { // Loose
         finish_game(zero_asset);
         return;
@@ -70,10 +127,7 @@ void proto_dice::on_random(uint64_t ses_id, checksum256 rand) {
 }
 
 void proto_dice::on_finish(uint64_t ses_id) {
-    const auto roll_itr = rolls.find(ses_id);
-    if (roll_itr != rolls.end()) {
-        rolls.erase(roll_itr);
-    }
+    rolls.release(ses_id);
 }
 
 } // namespace proto_dice
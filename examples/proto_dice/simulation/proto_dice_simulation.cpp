@@ -0,0 +1,55 @@
+#include <game_simulator/simulator.hpp>
+
+#include <proto_dice/proto_dice.hpp>
+
+#include <chrono>
+#include <iostream>
+
+/*
+ RTP estimation of proto_dice on native simulator.
+ Usage: proto_dice_simulation [rounds] [workers] [seed]
+*/
+
+int main(int argc, char** argv) try {
+    game_sim::run_config config;
+    if (argc > 1) {
+        config.rounds = std::stoull(argv[1]);
+    }
+    if (argc > 2) {
+        config.workers = std::stoul(argv[2]);
+    }
+    if (argc > 3) {
+        config.seed = std::stoull(argv[3]);
+    }
+
+    const game_sdk::game_params_type params = {
+        {proto_dice::proto_dice::min_bet_param_type, 1'0000},
+        {proto_dice::proto_dice::max_bet_param_type, 10'0000},
+        {proto_dice::proto_dice::max_payout_param_type, 20'0000},
+    };
+    const auto bet = eosio::asset(1'0000, game_sdk::game::core_symbol);
+
+    // player rolls uniform number from [1, 99]
+    const game_sim::player_t player = [](const auto&, std::mt19937_64& rng) {
+        return game_sim::player_action{proto_dice::proto_dice::roll_action_type, {1 + rng() % 99}};
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto stats = game_sim::run(
+        [&](uint64_t seed) { return std::make_unique<game_sim::simulator>("protodice"_n, params, seed); },
+        bet,
+        player,
+        config);
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "rounds: " << stats.rounds << ", failed: " << stats.failed << "\n"
+              << "rtp: " << stats.rtp() << "\n"
+              << "rounds/sec: " << stats.rounds / elapsed << std::endl;
+
+    return stats.failed == 0 ? 0 : 1;
+} catch (const std::exception& e) {
+    std::cerr << "simulation failed: " << e.what() << std::endl;
+    return 1;
+}
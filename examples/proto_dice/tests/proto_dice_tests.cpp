@@ -1,6 +1,9 @@
 #include <game_tester/game_tester.hpp>
+#include <game_tester/load_generator.hpp>
 #include <game_tester/strategy.hpp>
 
+#include <random>
+
 #include "contracts.hpp"
 
 namespace testing {
@@ -46,7 +49,10 @@ class proto_dice_tester : public game_tester {
                                    return strategy::Result::Continue;
                                });
 
-        auto executor = strategy::Executor(std::move(graph));
+        auto executor = strategy::CompiledExecutor<>(std::move(graph));
+
+        // block production dominates in long runs, so pack many rounds into one block
+        set_block_batch_size(100);
 
         const uint32_t bet = 1;
         executor.process_strategy(
@@ -58,6 +64,9 @@ class proto_dice_tester : public game_tester {
             },
             [&](game_tester& tester, const uint32_t session_id) { tester.signidice(game_name, session_id); });
 
+        produce_pending_block();
+        set_block_batch_size(1);
+
         const auto end_player_balance = to_double(get_balance(player_name));
         const double all_bets_balance = double(run_count) * bet;
 
@@ -90,6 +99,40 @@ BOOST_FIXTURE_TEST_CASE(new_session_test, proto_dice_tester) try {
 }
 FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE(typed_session_and_events_test, proto_dice_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("10.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    auto ses_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+
+    const auto session = get_session_typed(game_name, ses_id);
+    BOOST_REQUIRE(session.has_value());
+    BOOST_REQUIRE_EQUAL(session->ses_id, ses_id);
+    BOOST_REQUIRE_EQUAL(session->player, player_name);
+    BOOST_REQUIRE_EQUAL(uint32_t(session->state), 2); // req_action state
+    BOOST_REQUIRE_EQUAL(session->deposit, STRSYM("5.0000"));
+    BOOST_REQUIRE_EQUAL(session->digest, get_game_session(game_name, ses_id)["digest"].as<sha256>());
+    BOOST_REQUIRE_EQUAL(get_session_params(game_name, ses_id)->params.size(), 3);
+
+    game_action(game_name, ses_id, 0, {50});
+
+    const auto requests = get_events_typed<events::signidice_part_1_request>();
+    BOOST_REQUIRE(requests.has_value());
+    BOOST_REQUIRE_EQUAL(requests->size(), 1);
+    BOOST_REQUIRE_EQUAL(requests->at(0).digest, require_session(game_name, ses_id).digest);
+
+    signidice(game_name, ses_id);
+
+    BOOST_REQUIRE(get_events_typed<events::game_finished>().has_value());
+    BOOST_REQUIRE(!get_session_typed(game_name, ses_id).has_value());
+}
+FC_LOG_AND_RETHROW()
+
 BOOST_FIXTURE_TEST_CASE(max_win_min_test, proto_dice_tester) try {
     auto player_name = N(player);
 
@@ -177,6 +220,285 @@ BOOST_FIXTURE_TEST_CASE(full_session_success_test, proto_dice_tester) try {
 }
 FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE(resource_profile_test, proto_dice_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("10.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    resource_profiler profiler;
+    set_profiler(&profiler);
+
+    auto ses_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+    game_action(game_name, ses_id, 0, {90});
+    signidice(game_name, ses_id);
+
+    const auto& actions = profiler.samples(game_name, "gameaction");
+    BOOST_REQUIRE_EQUAL(actions.size(), 1);
+    BOOST_REQUIRE_GT(actions[0].elapsed_us, 0);
+    BOOST_REQUIRE_GT(actions[0].net_bytes, 0);
+
+    // session row is created on deposit and removed on finish
+    BOOST_REQUIRE_GT(profiler.phase_samples(game_name, "deposit")[0].ram_bytes, 0);
+    BOOST_REQUIRE_LT(profiler.samples(game_name, "sgdicesecond")[0].ram_bytes, 0);
+
+    BOOST_REQUIRE_EQUAL(profiler.phase_samples(game_name, "signidice").size(), 2);
+    BOOST_REQUIRE_CPU_BELOW(profiler, game_name, "gameaction", 99, 100000);
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(session_layout_test, proto_dice_tester) try {
+    // freshly deployed game has current session layout, nothing to migrate
+    const auto global = abi_ser[game_name].binary_to_variant(
+        "global_row", get_row_by_account(game_name, game_name, N(global), N(global)), abi_serializer_max_time);
+    BOOST_REQUIRE_EQUAL(global["session_layout"].as<uint32_t>(), 1);
+
+    BOOST_REQUIRE_EQUAL(push_action(game_name, N(migrate), game_name, mvo()),
+                        wasm_assert_msg("sessions are already migrated"));
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(shared_params_snapshot_test, proto_dice_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("20.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    const auto first_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+    const auto second_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+
+    // sessions with the same casino, token and params share single snapshot
+    BOOST_REQUIRE_EQUAL(get_table_size(game_name, game_name, N(params)), 1);
+    const auto snapshot = get_session_params(game_name, first_id);
+    BOOST_REQUIRE(snapshot.has_value());
+    BOOST_REQUIRE_EQUAL(snapshot->id, require_session(game_name, second_id).params_id);
+    BOOST_REQUIRE_EQUAL(snapshot->ref_count, 2);
+    BOOST_REQUIRE_EQUAL(snapshot->params.size(), 3);
+
+    game_action(game_name, first_id, 0, {50});
+    signidice(game_name, first_id);
+    BOOST_REQUIRE_EQUAL(get_session_params(game_name, second_id)->ref_count, 1);
+
+    // snapshot is erased with its last session
+    game_action(game_name, second_id, 0, {50});
+    signidice(game_name, second_id);
+    BOOST_REQUIRE_EQUAL(get_table_size(game_name, game_name, N(params)), 0);
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(roll_row_recycling_test, proto_dice_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("20.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    const auto first_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+    game_action(game_name, first_id, 0, {50});
+    signidice(game_name, first_id);
+
+    // row of finished session is kept as free
+    BOOST_REQUIRE_EQUAL(get_table_size(game_name, game_name, N(roll)), 1);
+    const auto ram_usage = get_ram_usage(game_name);
+
+    const auto second_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+    game_action(game_name, second_id, 0, {60});
+
+    const auto roll = abi_ser[game_name].binary_to_variant(
+        "roll_row", get_row_by_account(game_name, game_name, N(roll), 0), abi_serializer_max_time);
+    BOOST_REQUIRE_EQUAL(roll["ses_id"].as<uint64_t>(), second_id);
+    BOOST_REQUIRE_EQUAL(roll["number"].as<uint32_t>(), 60);
+
+    signidice(game_name, second_id);
+    BOOST_REQUIRE_EQUAL(get_table_size(game_name, game_name, N(roll)), 1);
+    BOOST_REQUIRE_EQUAL(get_ram_usage(game_name), ram_usage);
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(continuous_rounds_test, proto_dice_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("10.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    const auto player_balance_before = get_balance(player_name);
+    const auto casino_balance_before = get_balance(casino_name);
+
+    auto ses_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+
+    auto balance = STRSYM("5.0000");
+    for (int i = 0; i < 3; ++i) {
+        game_action(game_name, ses_id, 1, {50, 10000});
+        signidice(game_name, ses_id);
+
+        // round is settled without session finish
+        const auto rounds = get_events_typed<events::round_finished>();
+        BOOST_REQUIRE(rounds.has_value());
+        BOOST_REQUIRE_EQUAL(rounds->size(), 1);
+        BOOST_REQUIRE_EQUAL(rounds->at(0).balance, balance + rounds->at(0).player_win_amount);
+        BOOST_REQUIRE(!get_events_typed<events::game_finished>().has_value());
+        balance = rounds->at(0).balance;
+
+        const auto session = get_session_typed(game_name, ses_id);
+        BOOST_REQUIRE(session.has_value());
+        BOOST_REQUIRE_EQUAL(session->deposit, STRSYM("5.0000"));
+        BOOST_REQUIRE_EQUAL(uint32_t(session->state), 2); // req_action state
+    }
+
+    game_action(game_name, ses_id, 2, {});
+
+    BOOST_REQUIRE(get_events_typed<events::game_finished>().has_value());
+    BOOST_REQUIRE(!get_session_typed(game_name, ses_id).has_value());
+    BOOST_REQUIRE_EQUAL(get_balance(player_name), player_balance_before - STRSYM("5.0000") + balance);
+    BOOST_REQUIRE_EQUAL(get_balance(player_name) + get_balance(casino_name),
+                        player_balance_before + casino_balance_before);
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(continuous_rounds_single_roll_test, proto_dice_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("10.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    const auto player_balance_before = get_balance(player_name);
+
+    auto ses_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+    game_action(game_name, ses_id, 1, {50, 10000});
+    signidice(game_name, ses_id);
+    const auto balance = get_events_typed<events::round_finished>()->at(0).balance;
+
+    // single roll would pay against deposit and drop settled rounds
+    game_action(game_name,
+                ses_id,
+                0,
+                {1},
+                STRSYM("0"),
+                wasm_assert_msg("only round and cash out actions are allowed in continuous session"));
+
+    game_action(game_name, ses_id, 2, {});
+    BOOST_REQUIRE(!get_session_typed(game_name, ses_id).has_value());
+    BOOST_REQUIRE_EQUAL(get_balance(player_name), player_balance_before - STRSYM("5.0000") + balance);
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(continuous_rounds_expiration_test, proto_dice_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("10.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    const auto player_balance_before = get_balance(player_name);
+
+    auto ses_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+    game_action(game_name, ses_id, 1, {50, 10000});
+    signidice(game_name, ses_id);
+    const auto balance = get_events_typed<events::round_finished>()->at(0).balance;
+
+    // unfinished round is refunded, session is settled with balance
+    game_action(game_name, ses_id, 1, {50, 10000});
+    produce_block(fc::seconds(game_session_ttl + 1));
+    close_session(game_name, ses_id);
+
+    BOOST_REQUIRE(!get_session_typed(game_name, ses_id).has_value());
+    BOOST_REQUIRE_EQUAL(get_balance(player_name), player_balance_before - STRSYM("5.0000") + balance);
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(continuous_rounds_expiration_after_loss_test, proto_dice_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("10.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    const auto player_balance_before = get_balance(player_name);
+    const auto casino_balance_before = get_balance(casino_name);
+
+    auto ses_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+
+    // number 98 wins with 1% chance, round is repeated until player loses down to 1.0000
+    auto balance = STRSYM("5.0000");
+    while (balance >= STRSYM("5.0000")) {
+        game_action(game_name, ses_id, 1, {98, uint64_t((balance - STRSYM("1.0000")).get_amount())});
+        signidice(game_name, ses_id);
+        balance = get_events_typed<events::round_finished>()->at(0).balance;
+    }
+    BOOST_REQUIRE_EQUAL(balance, STRSYM("1.0000"));
+
+    // low risk bet keeps player behind deposit, casino locks no win
+    game_action(game_name, ses_id, 1, {1, 10000});
+    signidice_part_1(game_name, ses_id);
+    const auto session = require_session(game_name, ses_id);
+    BOOST_REQUIRE_EQUAL(uint32_t(session.state), 4); // req_signidice_part_2 state
+    BOOST_REQUIRE_EQUAL(session.last_max_win, STRSYM("0.0000"));
+
+    // casino didn't sign in time, session is closed with locked max win
+    produce_block(fc::seconds(game_session_ttl + 1));
+    close_session(game_name, ses_id);
+
+    BOOST_REQUIRE(!get_session_typed(game_name, ses_id).has_value());
+    BOOST_REQUIRE_EQUAL(get_balance(player_name), player_balance_before);
+    BOOST_REQUIRE_EQUAL(get_balance(player_name) + get_balance(casino_name),
+                        player_balance_before + casino_balance_before);
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(prefetch_random_test, proto_dice_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("10.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    auto ses_id = new_game_session(game_name, player_name, casino_id, STRSYM("5.0000"));
+    game_action(game_name, ses_id, 1, {50, 10000});
+    signidice(game_name, ses_id);
+
+    // next round's part 1 is requested together with player's action
+    const auto requests = get_events_typed<events::signidice_part_1_request>();
+    BOOST_REQUIRE(requests.has_value());
+    BOOST_REQUIRE_EQUAL(requests->at(0).digest, require_session(game_name, ses_id).digest);
+    BOOST_REQUIRE(get_events_typed<events::action_request>().has_value());
+
+    signidice_part_1(game_name, ses_id);
+    BOOST_REQUIRE(!get_events_typed<events::signidice_part_2_request>().has_value());
+    BOOST_REQUIRE_EQUAL(uint32_t(require_session(game_name, ses_id).state), 2); // req_action state
+    BOOST_REQUIRE_EQUAL(uint32_t(require_session(game_name, ses_id).prefetch), 2); // ready
+
+    // part 2 is requested right after action
+    game_action(game_name, ses_id, 1, {50, 10000});
+    const auto part_2_requests = get_events_typed<events::signidice_part_2_request>();
+    BOOST_REQUIRE(part_2_requests.has_value());
+    BOOST_REQUIRE_EQUAL(part_2_requests->at(0).digest, require_session(game_name, ses_id).digest);
+    BOOST_REQUIRE_EQUAL(uint32_t(require_session(game_name, ses_id).state), 4); // req_signidice_part_2 state
+
+    signidice_part_2(game_name, ses_id);
+    BOOST_REQUIRE(get_events_typed<events::round_finished>().has_value());
+}
+FC_LOG_AND_RETHROW()
+
 BOOST_FIXTURE_TEST_CASE(full_session_event, proto_dice_tester) try {
     auto player_name = N(player);
 
@@ -230,7 +552,7 @@ BOOST_FIXTURE_TEST_CASE(full_session_pseudo_test, proto_dice_tester) try {
     BOOST_REQUIRE_EQUAL(get_balance(game_name), STRSYM("5.0000"));
 
     push_next_random(game_name,
-                     sha256("0000000000000000000000000000000000000000000000000000000000000063") // 99
+                     sha256("ffffffffffffffff000000000000000000000000000000000000000000000000") // 99
     );
 
     game_action(game_name, ses_id, 0, {98});
@@ -560,6 +882,134 @@ try {
 }
 FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE(compiled_strategy_test, proto_dice_tester) try {
+    const auto player_name = N(player);
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("1000.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    auto graph = strategy::Graph([](game_tester&, const uint32_t) { return strategy::Result::Continue; });
+    graph.root->push_child([](const auto&) { return true; },
+                           [](auto& tester, const uint32_t ses_id) {
+                               tester.game_action(game_name, ses_id, 0, {50});
+                               return strategy::Result::Continue;
+                           });
+
+    auto executor = strategy::CompiledExecutor<>(std::move(graph));
+
+    strategy::Stats stats;
+    for (uint run = 0; run != 5; ++run) {
+        executor.process_run(
+            *this,
+            run,
+            10,
+            [&](game_tester& tester, const uint) {
+                return tester.new_game_session(game_name, player_name, casino_id, STRSYM("1.0000"));
+            },
+            [](game_tester& tester, const uint32_t ses_id) {
+                tester.signidice(game_name, ses_id);
+                return strategy::Outcome{1., 0.};
+            },
+            stats);
+    }
+
+    BOOST_REQUIRE_EQUAL(stats.runs, 5);
+    BOOST_REQUIRE_EQUAL(stats.aborted, 0);
+    BOOST_REQUIRE(stats.node_hits == std::vector<uint64_t>({5u, 5u}));
+}
+FC_LOG_AND_RETHROW()
+
+/* parallel strategy executor shared by parallel tests, player rolls uniform number from [1, 99] */
+strategy::Stats proto_dice_parallel_run(const uint workers, const uint run_count) {
+    const auto player_name = N(player);
+    const auto bet = STRSYM("1.0000");
+
+    auto executor = strategy::ParallelExecutor<proto_dice_tester, strategy::CompiledExecutor<>>(
+        [](std::mt19937_64& rng) {
+            auto graph = strategy::Graph([](game_tester&, const uint32_t) { return strategy::Result::Continue; });
+            graph.root->push_child([](const auto&) { return true; },
+                                   [&rng](auto& tester, const uint32_t ses_id) {
+                                       const auto number = 1 + rng() % 99;
+                                       tester.push_game_action(proto_dice_tester::game_name, ses_id, 0, {number});
+                                       return strategy::Result::Continue;
+                                   });
+            return graph;
+        },
+        workers);
+
+    return executor.process_strategy(
+        [&](const uint, const uint64_t) {
+            auto tester = std::make_unique<proto_dice_tester>();
+            tester->create_player(player_name);
+            tester->link_game(player_name, proto_dice_tester::game_name);
+            tester->transfer(N(eosio), player_name, STRSYM("1000000.0000"));
+            tester->transfer(N(eosio), game_tester::casino_name, STRSYM("1000000.0000"));
+            tester->set_block_batch_size(100);
+            return tester;
+        },
+        run_count,
+        10,
+        [&](proto_dice_tester& tester, const uint) {
+            return tester.push_new_game_session(proto_dice_tester::game_name, player_name, game_tester::casino_id, bet);
+        },
+        [&](proto_dice_tester& tester, const uint32_t ses_id) {
+            // runs on worker thread, so failure is thrown to executor instead of Boost assertion
+            tester.push_signidice(proto_dice_tester::game_name, ses_id);
+            const auto finished = tester.get_events_typed<events::game_finished>();
+            if (!finished) {
+                throw std::runtime_error("game isn't finished after signidice");
+            }
+
+            const auto payout = bet + finished->at(0).player_win_amount;
+            return strategy::Outcome{1., double(payout.get_amount()) / bet.get_amount()};
+        });
+}
+
+BOOST_AUTO_TEST_CASE(proto_dice_parallel_test) try {
+    // 2 workers x 50 runs
+    const auto stats = proto_dice_parallel_run(2, 100);
+
+    BOOST_REQUIRE_EQUAL(stats.runs, 100);
+    BOOST_REQUIRE_EQUAL(stats.aborted, 0);
+    BOOST_REQUIRE(stats.node_hits == std::vector<uint64_t>({100u, 100u}));
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE(proto_dice_parallel_rtp_test, *boost::unit_test::disabled()) try {
+    const auto stats = proto_dice_parallel_run(std::max(std::thread::hardware_concurrency(), 1u), 10000);
+
+    BOOST_REQUIRE_EQUAL(stats.aborted, 0);
+    BOOST_TEST(stats.rtp() == 0.67, boost::test_tools::tolerance(0.035));
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(proto_dice_load_test, proto_dice_tester, *boost::unit_test::disabled()) try {
+    transfer(N(eosio), casino_name, STRSYM("1000000.0000"));
+    set_block_batch_size(100);
+
+    load::config config;
+    config.players = 50;
+    config.levels = {1, 10, 100, 1000, 3000};
+
+    auto generator = load::load_generator(
+        *this, game_name, [](game_tester& tester, uint64_t ses_id) { tester.game_action(game_name, ses_id, 0, {50}); },
+        config);
+    const auto points = generator.run();
+    load::load_generator::write_csv(points, "proto_dice_load.csv");
+
+    BOOST_REQUIRE_EQUAL(points.back().session_rows, config.levels.back());
+
+    // action cost shouldn't depend on number of live sessions
+    for (const auto action : {"newgame", "gameaction", "sgdicesecond"}) {
+        BOOST_TEST_MESSAGE(action << " cpu p50: " << points.front().cpu_p50.at(action) << "us -> "
+                                  << points.back().cpu_p50.at(action) << "us");
+        BOOST_REQUIRE_LT(points.back().cpu_p50.at(action), points.front().cpu_p50.at(action) * 2);
+    }
+}
+FC_LOG_AND_RETHROW()
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace testing
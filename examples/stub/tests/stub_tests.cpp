@@ -79,6 +79,62 @@ BOOST_FIXTURE_TEST_CASE(full_session_success_test, stub_tester) try {
 }
 FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE(full_session_batched_blocks_test, stub_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, STRSYM("10.0000"));
+    transfer(N(eosio), casino_name, STRSYM("1000.0000"));
+
+    auto casino_balance_before = get_balance(casino_name);
+    auto player_balance_before = get_balance(player_name);
+    const auto head_block_before = control->head_block_num();
+
+    set_block_batch_size(100);
+
+    auto player_bet = STRSYM("5.0000");
+    auto ses_id = new_game_session(game_name, player_name, casino_id, player_bet);
+
+    game_action(game_name, ses_id, 0, {0});
+    BOOST_REQUIRE(get_events(events_id::signidice_part_1_request) != std::nullopt);
+
+    signidice(game_name, ses_id);
+    BOOST_REQUIRE(get_events(events_id::game_finished) != std::nullopt);
+
+    // whole round is still in the pending block
+    BOOST_REQUIRE_EQUAL(control->head_block_num(), head_block_before);
+    produce_pending_block();
+    BOOST_REQUIRE_EQUAL(control->head_block_num(), head_block_before + 1);
+
+    BOOST_REQUIRE_EQUAL(get_game_session(game_name, ses_id).is_null(), true);
+    BOOST_REQUIRE_EQUAL(player_balance_before - player_bet, get_balance(player_name));
+    BOOST_REQUIRE_EQUAL(casino_balance_before + player_bet, get_balance(casino_name));
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(full_block_batch_test, stub_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    transfer(N(eosio), player_name, STRSYM("1000.0000"));
+
+    // batch is clamped to transactions which fit block CPU limit
+    set_block_batch_size(1000);
+    const auto batch_size = get_block_batch_size();
+    BOOST_REQUIRE_EQUAL(batch_size, max_block_batch_size());
+    BOOST_REQUIRE_LT(batch_size, 1000);
+
+    // full batch is produced as one block
+    const auto head_block_before = control->head_block_num();
+    for (uint32_t i = 0; i < batch_size; ++i) {
+        BOOST_REQUIRE_EQUAL(transfer(player_name, N(eosio), STRSYM("0.0001")), success());
+    }
+    BOOST_REQUIRE_EQUAL(control->head_block_num(), head_block_before + 1);
+}
+FC_LOG_AND_RETHROW()
+
 #ifdef IS_DEBUG
 BOOST_FIXTURE_TEST_CASE(full_session_pseudo_random_test, stub_tester) try {
     auto player_name = N(player);
@@ -334,6 +334,39 @@ BOOST_FIXTURE_TEST_CASE(ban_test, win_raise_lose_tester) try {
 }
 FC_LOG_AND_RETHROW()
 
+BOOST_FIXTURE_TEST_CASE(session_state_test, win_raise_lose_tester) try {
+    auto player_name = N(player);
+
+    create_player(player_name);
+    link_game(player_name, game_name);
+
+    transfer(N(eosio), player_name, ASSET("10.00000 KEK"));
+    transfer(N(eosio), casino_name, ASSET("1000.00000 KEK"));
+
+    auto ses_id = new_game_session(game_name, player_name, casino_id, ASSET("5.00000 KEK"));
+    BOOST_REQUIRE_EQUAL(get_table_size(game_name, game_name, N(gamestate)), 0);
+
+    // state is stored on action end: ses_id and deposit
+    game_action(game_name, ses_id, 0, {2});
+    BOOST_REQUIRE_EQUAL(get_table_size(game_name, game_name, N(gamestate)), 1);
+    const auto data = get_row_by_account(game_name, game_name, N(gamestate), ses_id);
+    const auto state = fc::raw::unpack<std::pair<uint64_t, asset>>(data);
+    BOOST_REQUIRE_EQUAL(state.first, ses_id);
+    BOOST_REQUIRE_EQUAL(state.second, ASSET("5.00000 KEK"));
+
+    game_action(game_name, ses_id, 0, {2}, ASSET("5.00000 KEK"));
+    BOOST_REQUIRE_EQUAL(
+        fc::raw::unpack<std::pair<uint64_t, asset>>(get_row_by_account(game_name, game_name, N(gamestate), ses_id))
+            .second,
+        ASSET("10.00000 KEK"));
+
+    // state is erased with session
+    game_action(game_name, ses_id, 0, {1});
+    BOOST_REQUIRE(!get_session_typed(game_name, ses_id).has_value());
+    BOOST_REQUIRE_EQUAL(get_table_size(game_name, game_name, N(gamestate)), 0);
+}
+FC_LOG_AND_RETHROW()
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace testing
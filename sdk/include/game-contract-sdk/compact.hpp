@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <eosio/eosio.hpp>
+
+/*
+ Compact encodings of game event payloads (`game_message`, `game_finished` msg).
+ Default `eosio::pack(std::vector<param_t>)` spends 8 bytes per value, compact formats are:
+
+    header  | count (LEB128) | body
+    0x11    | n              | n values as LEB128 varints
+    0x12    | n              | bit width w (1 byte, 1..64), n values by w bits, LSB first, last byte zero padded
+
+ Header is `version << 4 | kind`, decoders should reject unknown headers.
+ Decoder for tests is `testing::compact::decode` of game tester.
+*/
+
+namespace service::compact {
+
+using bytes = std::vector<char>;
+
+static constexpr uint8_t version = 1u;
+
+enum class kind : uint8_t {
+    varint = 1,
+    bitpacked = 2,
+};
+
+constexpr uint8_t header(kind type) { return uint8_t(version << 4) | static_cast<uint8_t>(type); }
+
+namespace detail {
+inline void put_varint(bytes& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(char(uint8_t(value) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(char(value));
+}
+
+constexpr size_t varint_size(uint64_t value) {
+    size_t size = 1;
+    for (; value >= 0x80; value >>= 7) {
+        ++size;
+    }
+    return size;
+}
+
+constexpr uint8_t bit_width(uint64_t value) {
+    uint8_t width = 0;
+    for (; value != 0; value >>= 1) {
+        ++width;
+    }
+    return width;
+}
+
+inline uint64_t get_varint(const bytes& in, size_t& pos) {
+    uint64_t value = 0;
+    for (uint32_t shift = 0;; shift += 7) {
+        eosio::check(pos < in.size() && shift < 64, "malformed compact varint");
+        const auto byte = uint8_t(in[pos++]);
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+}
+} // namespace detail
+
+inline bytes encode_varints(const std::vector<uint64_t>& values) {
+    bytes out;
+    out.reserve(1 + detail::varint_size(values.size()) + values.size());
+    out.push_back(char(header(kind::varint)));
+    detail::put_varint(out, values.size());
+    for (const auto value : values) {
+        detail::put_varint(out, value);
+    }
+    return out;
+}
+
+/* every value should fit in `bits` */
+inline bytes encode_bitpacked(const std::vector<uint64_t>& values, uint8_t bits) {
+    eosio::check(bits >= 1 && bits <= 64, "bit width should be in [1, 64]");
+
+    bytes out;
+    out.reserve(2 + detail::varint_size(values.size()) + (values.size() * bits + 7) / 8);
+    out.push_back(char(header(kind::bitpacked)));
+    detail::put_varint(out, values.size());
+    out.push_back(char(bits));
+
+    uint128_t acc = 0;
+    uint32_t filled = 0;
+    for (const auto value : values) {
+        eosio::check(bits == 64 || value >> bits == 0, "value exceeds bit width");
+        acc |= uint128_t(value) << filled;
+        for (filled += bits; filled >= 8; filled -= 8) {
+            out.push_back(char(uint8_t(acc)));
+            acc >>= 8;
+        }
+    }
+    if (filled > 0) {
+        out.push_back(char(uint8_t(acc)));
+    }
+    return out;
+}
+
+/* the smaller of varint and bitpacked encodings */
+inline bytes encode(const std::vector<uint64_t>& values) {
+    uint8_t bits = 1;
+    size_t varints_size = 0;
+    for (const auto value : values) {
+        bits = std::max(bits, detail::bit_width(value));
+        varints_size += detail::varint_size(value);
+    }
+
+    // header, count and width are the same for both except width byte
+    if (varints_size <= 1 + (values.size() * bits + 7) / 8) {
+        return encode_varints(values);
+    }
+    return encode_bitpacked(values, bits);
+}
+
+inline std::vector<uint64_t> decode(const bytes& in) {
+    eosio::check(!in.empty(), "empty compact payload");
+
+    size_t pos = 1;
+    const auto count = detail::get_varint(in, pos);
+    std::vector<uint64_t> values;
+
+    switch (uint8_t(in[0])) {
+    case header(kind::varint):
+        eosio::check(count <= in.size() - pos, "malformed compact payload");
+        values.reserve(count);
+        for (uint64_t i = 0; i != count; ++i) {
+            values.push_back(detail::get_varint(in, pos));
+        }
+        break;
+    case header(kind::bitpacked): {
+        eosio::check(pos < in.size(), "malformed compact payload");
+        const auto bits = uint8_t(in[pos++]);
+        eosio::check(bits >= 1 && bits <= 64, "malformed compact payload");
+        eosio::check(count <= (in.size() - pos) * 8 / bits, "malformed compact payload");
+        const auto mask = bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+
+        values.reserve(count);
+        uint128_t acc = 0;
+        uint32_t filled = 0;
+        for (uint64_t i = 0; i != count; ++i) {
+            for (; filled < bits; filled += 8) {
+                acc |= uint128_t(uint8_t(in[pos++])) << filled;
+            }
+            values.push_back(uint64_t(acc) & mask);
+            acc >>= bits;
+            filled -= bits;
+        }
+        break;
+    }
+    default:
+        eosio::check(false, "unknown compact payload header");
+    }
+
+    eosio::check(pos == in.size(), "malformed compact payload");
+    return values;
+}
+
+} // namespace service::compact
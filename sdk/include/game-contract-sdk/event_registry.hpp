@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/*
+ Compile-time registry of game events shared by game contract and game tester.
+ Event is struct with `static constexpr` id `type` which isn't serialized, registry is list of them:
+
+    using sdk_events = game_sdk::event_registry<game_started, action_request, ...>;
+    using my_events = sdk_events::with<my_event>;
+
+ Ids index dispatch tables of event decoders, so they should be unique and below `max_event_type`.
+ SDK events use ids below `first_custom_event_type`, games' own events use the rest.
+ Header doesn't depend on eosio, tester and host tools include it too.
+*/
+
+namespace game_sdk {
+
+static constexpr uint32_t max_event_type = 256u;
+static constexpr uint32_t first_custom_event_type = 128u;
+
+/*
+ Ids of SDK events. Contract structs `game_sdk::game::events` take them from here,
+ tester keeps own mirror of those structs and checks it against this table.
+*/
+namespace sdk_event_ids {
+static constexpr uint32_t game_started = 0u;
+static constexpr uint32_t action_request = 1u;
+static constexpr uint32_t signidice_part_1_request = 2u;
+static constexpr uint32_t signidice_part_2_request = 3u;
+static constexpr uint32_t game_finished = 4u;
+static constexpr uint32_t game_failed = 5u;
+static constexpr uint32_t game_message = 6u;
+static constexpr uint32_t round_finished = 7u;
+
+static constexpr size_t count = 8u;
+} // namespace sdk_event_ids
+
+template <typename Event> constexpr uint32_t event_type() { return static_cast<uint32_t>(Event::type); }
+
+namespace detail {
+template <typename... Events> constexpr bool valid_event_types() {
+    constexpr uint32_t types[] = {event_type<Events>()..., 0u}; // trailing item for empty list
+    for (size_t i = 0; i != sizeof...(Events); ++i) {
+        if (types[i] >= max_event_type) {
+            return false;
+        }
+        for (size_t j = 0; j != i; ++j) {
+            if (types[i] == types[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Registry, typename... Custom> struct with_custom_events;
+} // namespace detail
+
+template <typename... Events> struct event_registry {
+    static_assert(detail::valid_event_types<Events...>(), "event types should be unique and below max_event_type");
+
+    static constexpr size_t size = sizeof...(Events);
+
+    template <typename Event> static constexpr bool contains = (std::is_same_v<Event, Events> || ...);
+
+    /* registry extended by game's custom events */
+    template <typename... Custom> using with = typename detail::with_custom_events<event_registry, Custom...>::type;
+
+    /* calls `visitor(static_cast<Event*>(nullptr))` for every event in order */
+    template <typename Visitor> static void for_each(Visitor&& visitor) {
+        (visitor(static_cast<Events*>(nullptr)), ...);
+    }
+};
+
+namespace detail {
+template <typename... Events, typename... Custom> struct with_custom_events<event_registry<Events...>, Custom...> {
+    static_assert(((event_type<Custom>() >= first_custom_event_type) && ...),
+                  "custom event type should be at least first_custom_event_type");
+    static_assert(valid_event_types<Events..., Custom...>(), "event types should be unique and below max_event_type");
+
+    using type = event_registry<Events..., Custom...>;
+};
+} // namespace detail
+
+} // namespace game_sdk
@@ -8,11 +8,16 @@
 #include <platform/platform.hpp>
 
 #include <eosio/asset.hpp>
+#include <eosio/binary_extension.hpp>
 #include <eosio/crypto.hpp>
 #include <eosio/eosio.hpp>
 #include <eosio/serialize.hpp>
 
+#include <game-contract-sdk/compact.hpp>
 #include <game-contract-sdk/dispatcher.hpp>
+#include <game-contract-sdk/event_registry.hpp>
+#include <game-contract-sdk/payout_math.hpp>
+#include <game-contract-sdk/recycled_table.hpp>
 #include <game-contract-sdk/service.hpp>
 
 // abi generator hack
@@ -53,18 +58,25 @@ class game : public eosio::contract {
         req_signidice_part_2,   // <- req_signidice_part_1, -> finished|req_allow_deposit|req_action|failed
         finished,               // <- req_signidice_part_2
     };
+
+    /* stages of next round random prefetch, see `prefetch_random` */
+    enum class prefetch : uint8_t {
+        none = 0,
+        requested,              // <- signidice part 1 is requested while player makes action
+        ready,                  // <- part 1 is done, its digest waits for player's action
+    };
     // clang-format on
 
     /* event data structures, type field doesn't serialize */
     struct events {
         struct game_started {
-            static constexpr uint32_t type{0u};
+            static constexpr uint32_t type{sdk_event_ids::game_started};
 
             EOSLIB_SERIALIZE(game_started, )
         };
 
         struct action_request {
-            static constexpr uint32_t type{1u};
+            static constexpr uint32_t type{sdk_event_ids::action_request};
 
             uint8_t action_type;
             bool need_deposit; // actually allow_deposit but it's hard to rename
@@ -72,21 +84,21 @@ class game : public eosio::contract {
         };
 
         struct signidice_part_1_request {
-            static constexpr uint32_t type{2u};
+            static constexpr uint32_t type{sdk_event_ids::signidice_part_1_request};
 
             checksum256 digest;
             EOSLIB_SERIALIZE(signidice_part_1_request, (digest))
         };
 
         struct signidice_part_2_request {
-            static constexpr uint32_t type{3u};
+            static constexpr uint32_t type{sdk_event_ids::signidice_part_2_request};
 
             checksum256 digest;
             EOSLIB_SERIALIZE(signidice_part_2_request, (digest))
         };
 
         struct game_finished {
-            static constexpr uint32_t type{4u};
+            static constexpr uint32_t type{sdk_event_ids::game_finished};
 
             asset player_win_amount;
             bytes msg;
@@ -94,7 +106,7 @@ class game : public eosio::contract {
         };
 
         struct game_failed {
-            static constexpr uint32_t type{5u};
+            static constexpr uint32_t type{sdk_event_ids::game_failed};
 
             asset player_win_amount;
             bytes msg;
@@ -102,19 +114,43 @@ class game : public eosio::contract {
         };
 
         struct game_message {
-            static constexpr uint32_t type{6u};
+            static constexpr uint32_t type{sdk_event_ids::game_message};
 
             bytes msg;
             EOSLIB_SERIALIZE(game_message, (msg))
         };
+
+        struct round_finished {
+            static constexpr uint32_t type{sdk_event_ids::round_finished};
+
+            asset player_win_amount; // round profit, negative on loss
+            asset balance;           // session balance after round
+            bytes msg;
+            EOSLIB_SERIALIZE(round_finished, (player_win_amount)(balance)(msg))
+        };
+
+        /* SDK events, mirrored by `testing::game_events` of game tester */
+        using registry = event_registry<game_started,
+                                        action_request,
+                                        signidice_part_1_request,
+                                        signidice_part_2_request,
+                                        game_finished,
+                                        game_failed,
+                                        game_message,
+                                        round_finished>;
+        static_assert(registry::size == sdk_event_ids::count, "every SDK event should have id in sdk_event_ids");
     };
 
+    /* layout of session rows, games deployed before params snapshots have no version and should call `migrate` */
+    static constexpr uint32_t session_layout_version = 1u;
+
     /* global state variables */
     struct [[eosio::table("global"), eosio::contract("game")]] global_row {
         uint64_t session_seq{0u};
         name platform;
         name events;
         uint32_t session_ttl;
+        eosio::binary_extension<uint32_t> session_layout; // <- version of session rows layout
     };
     using global_singleton = eosio::singleton<"global"_n, global_row>;
 
@@ -126,7 +162,7 @@ class game : public eosio::contract {
         uint64_t ses_seq;
         name player;
         uint8_t state;
-        game_params_type params; // <- game params, copied from casino contract; avoid params changing during active session
+        uint64_t params_id;      // <- id of game params snapshot, avoids params changing during active session
         std::string token;       // <- deposit token
         asset deposit;           // <- player's total deposit = real tokens + bonus, increases on
                                  //    transfer, newgamebon and depositbon actions
@@ -135,6 +171,7 @@ class game : public eosio::contract {
         time_point last_update;  // <- last action time
         asset last_max_win;      // <- last max win value, updated after on_action
         bool acted;              // <- player first action flag
+        uint8_t prefetch;        // <- stage of next round random prefetch
 
         uint64_t primary_key() const { return ses_id; }
     };
@@ -142,9 +179,70 @@ class game : public eosio::contract {
 
     using session_table = eosio::multi_index<"session"_n, session_row>;
 
+    /* session layout of games deployed before params snapshots, read only by `migrate` */
+    struct legacy_session_row {
+        uint64_t ses_id;
+        uint64_t casino_id;
+        uint64_t ses_seq;
+        name player;
+        uint8_t state;
+        game_params_type params;
+        std::string token;
+        asset deposit;
+        asset bonus_deposit;
+        checksum256 digest;
+        time_point last_update;
+        asset last_max_win;
+        bool acted;
+
+        uint64_t primary_key() const { return ses_id; }
+
+        EOSLIB_SERIALIZE(legacy_session_row,
+                         (ses_id)(casino_id)(ses_seq)(player)(state)(params)(token)(deposit)(bonus_deposit)(digest)(
+                             last_update)(last_max_win)(acted))
+    };
+
+    using legacy_session_table = eosio::multi_index<"session"_n, legacy_session_row>;
+
+    /* game params snapshot, shared by all sessions started with the same params */
+    // clang-format off
+    struct [[eosio::table("params"), eosio::contract("game")]] params_row {
+        uint64_t id;
+        uint64_t casino_id;
+        std::string token;
+        game_params_type params; // <- game params, copied from casino contract
+        checksum256 hash;        // <- hash of casino_id, token and params
+        uint64_t ref_count;      // <- count of sessions referencing snapshot, snapshot is erased at zero
+
+        uint64_t primary_key() const { return id; }
+        checksum256 by_hash() const { return hash; }
+    };
+    // clang-format on
+
+    using params_table = eosio::multi_index<
+        "params"_n,
+        params_row,
+        eosio::indexed_by<"hash"_n, eosio::const_mem_fun<params_row, checksum256, &params_row::by_hash>>>;
+
+    /* results of continuous session, row exists only for sessions with settled rounds */
+    // clang-format off
+    struct [[eosio::table("round"), eosio::contract("game")]] round_row {
+        uint64_t slot;
+        uint64_t ses_id;
+        uint64_t rounds;    // <- count of settled rounds
+        asset net_win;      // <- player's total profit over deposit, negative when player is behind
+
+        uint64_t primary_key() const { return slot; }
+        uint64_t by_ses_id() const { return ses_id; }
+    };
+    // clang-format on
+
+    using round_table = recycled_table<"round"_n, round_row>;
+
   public:
     game(name receiver, name code, eosio::datastream<const char*> ds)
-        : contract(receiver, code, ds), sessions(_self, _self.value) {
+        : contract(receiver, code, ds), sessions(_self, _self.value), params_snapshots(_self, _self.value),
+          session_rounds(_self, _self.value) {
         // load global singleton to memory
         global = global_singleton(_self, _self.value).get_or_default();
 
@@ -170,6 +268,8 @@ class game : public eosio::contract {
     virtual void on_init() {}
     /* game session finalization callback */
     virtual void on_finish(uint64_t ses_id) {}
+    /* session removal callback for SDK extensions, invoked on finish and close before on_finish */
+    virtual void on_erase_session(uint64_t ses_id) {}
 
     // =============================================================
     // Must be overridden
@@ -186,21 +286,37 @@ class game : public eosio::contract {
     const global_row& get_global() const { return global; }
 
     const session_row& get_session(uint64_t ses_id) const {
+        check_session_layout();
         return sessions.get(ses_id, "session with this ses_id not found");
     }
 
+    const game_params_type& get_session_params(uint64_t ses_id) const {
+        const auto& session = get_session(ses_id);
+        return params_snapshots.get(session.params_id, "session params not found").params;
+    }
+
     std::optional<param_t> get_param_value(uint64_t ses_id, uint16_t param_type) const {
-        const auto& session = sessions.get(ses_id);
+        const auto& params = get_session_params(ses_id);
 
-        const auto itr = std::find_if(
-            session.params.begin(), session.params.end(), [&](const auto& item) { return item.first == param_type; });
+        const auto itr =
+            std::find_if(params.begin(), params.end(), [&](const auto& item) { return item.first == param_type; });
 
-        return itr == session.params.end() ? std::nullopt : std::optional<param_t>{itr->second};
+        return itr == params.end() ? std::nullopt : std::optional<param_t>{itr->second};
+    }
+
+    /* player's balance in session: deposit with results of settled rounds */
+    asset get_session_balance(uint64_t ses_id) const {
+        const auto& session = get_session(ses_id);
+        const auto* round = session_rounds.find(ses_id);
+        return round ? session.deposit + round->net_win : session.deposit;
     }
 
+    /* true when session has settled rounds, such session is finished only by `cash_out` */
+    bool has_rounds(uint64_t ses_id) const { return session_rounds.find(ses_id) != nullptr; }
+
     const symbol get_session_symbol(uint64_t ses_id) const {
         const auto& session = get_session(ses_id);
-        return token::get_symbol(get_platform(), session.token);
+        return get_token_symbol(session.token);
     }
 
     // =============================================================
@@ -244,8 +360,34 @@ class game : public eosio::contract {
 
         check_only_states(session, {state::req_action, state::req_signidice_part_2}, "state should be 'req_action' or 'req_signidice_part_2'");
 
+        const auto stage = static_cast<prefetch>(session.prefetch);
+        sessions.modify(session, get_self(), [&](auto& obj) {
+            obj.state = static_cast<uint8_t>(stage == prefetch::ready ? state::req_signidice_part_2
+                                                                      : state::req_signidice_part_1);
+            obj.prefetch = static_cast<uint8_t>(prefetch::none);
+        });
+
+        // prefetched part 1 request is already sent, platform answers it in regular flow
+        if (stage == prefetch::ready) {
+            emit_event(session, events::signidice_part_2_request{session.digest});
+        } else if (stage == prefetch::none) {
+            emit_event(session, events::signidice_part_1_request{session.digest});
+        }
+    }
+
+    /*
+     Requests signidice part 1 of next round while player makes action, should be called after `require_action`.
+     Part 2 is requested by `require_random` after player's action only, so random isn't revealed before action.
+    */
+    void prefetch_random() {
+        const auto& session = get_session(current_session);
+
+        check_only_states(
+            session, {state::req_action, state::req_allow_deposit}, "state should be 'req_action' or 'req_allow_deposit'");
+        eosio::check(static_cast<prefetch>(session.prefetch) == prefetch::none, "random is already prefetched");
+
         sessions.modify(
-            session, get_self(), [&](auto& obj) { obj.state = static_cast<uint8_t>(state::req_signidice_part_1); });
+            session, get_self(), [&](auto& obj) { obj.prefetch = static_cast<uint8_t>(prefetch::requested); });
 
         emit_event(session, events::signidice_part_1_request{session.digest});
     }
@@ -254,6 +396,16 @@ class game : public eosio::contract {
 
     void send_game_message(std::vector<param_t>&& msg) { send_game_message(eosio::pack(msg)); }
 
+    /* game's own event listed in game's registry `events::registry::with<...>`, e.g. `send_event<my_events>(ev)` */
+    template <typename Registry, typename Event> void send_event(const Event& event) {
+        static_assert(Registry::template contains<events::game_started>,
+                      "game's registry should extend events::registry");
+        static_assert(Registry::template contains<Event>, "event should be in game's registry");
+        static_assert(event_type<Event>() >= first_custom_event_type && event_type<Event>() < max_event_type,
+                      "custom event type should be in [first_custom_event_type, max_event_type)");
+        emit_event(get_session(current_session), event);
+    }
+
     void finish_game(asset player_payout) {
         const auto& session = get_session(current_session);
         finish_game(player_payout, std::nullopt);
@@ -263,18 +415,18 @@ class game : public eosio::contract {
         eosio::check(player_win.amount > 0, "invariant check failed: player win should be positive");
         eosio::check(player_win.symbol.code().to_string() == session.token, "incorrect player_win token");
 
-        const auto bonus_win = player_win * session.bonus_deposit.amount / session.deposit.amount;
-        const auto real_win = player_win - bonus_win;
-        const auto real_deposit = session.deposit - session.bonus_deposit;
+        const auto result =
+            service::payout_math::settle_win(session.deposit.amount, session.bonus_deposit.amount, player_win.amount);
+        const auto to_asset = [&](int64_t amount) { return asset(amount, session.deposit.symbol); };
 
         const auto casino_name = get_casino(session.casino_id);
         // transfer win
-        transfer_from_casino(casino_name, session.player, real_win);
-        transfer_bonus_from_casino(casino_name, session.player, session.bonus_deposit + bonus_win);
+        transfer_from_casino(casino_name, session.player, to_asset(result.real_win));
+        transfer_bonus_from_casino(casino_name, session.player, to_asset(result.bonus_payout));
 
         // transfer back real deposit
-        transfer(session.player, real_deposit, memo);
-        notify_new_real_payout(session, real_deposit + real_win);
+        transfer(session.player, to_asset(result.real_refund), memo);
+        notify_new_real_payout(session, to_asset(result.real_payout()));
     }
 
     void handle_player_loss_or_tie(const session_row& session, const asset player_payout, std::string memo = "") {
@@ -283,55 +435,82 @@ class game : public eosio::contract {
         if (memo.find("session expired") == std::string::npos) {
             memo = player_payout < session.deposit ? "player loss[game]" : "player tie[game]";
         }
-        const auto bonus_payout = player_payout * session.bonus_deposit.amount / session.deposit.amount;
-        const auto real_payout = player_payout - bonus_payout;
+
+        const auto result = service::payout_math::settle_loss(
+            session.deposit.amount, session.bonus_deposit.amount, player_payout.amount);
+        const auto to_asset = [&](int64_t amount) { return asset(amount, session.deposit.symbol); };
 
         const auto casino_name = get_casino(session.casino_id);
-        transfer(session.player, real_payout, memo);
-        transfer_bonus_from_casino(casino_name, session.player, bonus_payout);
+        transfer(session.player, to_asset(result.real_refund), memo);
+        transfer_bonus_from_casino(casino_name, session.player, to_asset(result.bonus_payout));
 
         /* only transfer real win, bonuses are 'burned' */
-        const auto real_deposit = session.deposit - session.bonus_deposit;
-        const auto casino_real_win = real_deposit - real_payout;
-        transfer(casino_name, casino_real_win, "casino win");
+        transfer(casino_name, to_asset(result.casino_win), "casino win");
 
-        if (real_payout.amount > 0) {
-            notify_new_real_payout(session, real_payout);
+        if (result.real_payout() > 0) {
+            notify_new_real_payout(session, to_asset(result.real_payout()));
         }
     }
 
     void finish_game(asset player_payout, std::optional<std::vector<param_t>>&& msg) {
+        finish_game(player_payout, msg.has_value() ? eosio::pack(msg.value()) : bytes{});
+    }
+
+    /* `msg` is already encoded payload, e.g. by `service::compact::encode` */
+    void finish_game(asset player_payout, bytes&& msg) {
+        // payout over deposit would drop results of settled rounds
+        eosio::check(!has_rounds(current_session), "session with settled rounds should be finished by cash out");
+        finish_session(player_payout, std::move(msg));
+    }
+
+    /*
+     Settles round of continuous session without finishing it, `round_win` is player's profit in round.
+     Casino keeps locked only realized player win, next round should lock its max win by `update_max_win`
+     counted from `get_session_balance`. Session is settled by `cash_out` or by `close` on expiry.
+    */
+    void settle_round(asset round_win, std::optional<std::vector<param_t>>&& msg = std::nullopt) {
         const auto& session = get_session(current_session);
 
         check_only_states(session,
                           {state::req_action, state::req_signidice_part_2},
                           "state should be 'req_signidice_part_2' or 'req_action'");
-        eosio::check(session.token == player_payout.symbol.code().to_string(), "incorrect player_payout token");
-        // player_payout is total payout, here we calculate player profit
-        const auto player_win = player_payout - session.deposit;
-        eosio::check(player_win <= session.last_max_win, "player win should be less than 'last_max_win'");
-
-        if (player_win.amount > 0) {
-            handle_player_win(session, player_win);
+        eosio::check(session.token == round_win.symbol.code().to_string(), "incorrect round_win token");
+
+        const auto* round = session_rounds.find(session.ses_id);
+        const auto net_win = round ? round->net_win + round_win : round_win;
+        eosio::check(net_win <= session.last_max_win, "player win should be less than 'last_max_win'");
+        eosio::check(-net_win <= session.deposit, "player loss cannot exceed deposit");
+
+        if (round) {
+            session_rounds.modify(*round, get_self(), [&](auto& row) {
+                row.rounds++;
+                row.net_win = net_win;
+            });
         } else {
-            handle_player_loss_or_tie(session, player_payout);
+            session_rounds.emplace(get_self(), session.ses_id, [&](auto& row) {
+                row.rounds = 1u;
+                row.net_win = net_win;
+            });
+        }
+
+        const auto realized_win = std::max(net_win, asset(0, net_win.symbol));
+        if (realized_win != session.last_max_win) {
+            notify_update_session(session, realized_win - session.last_max_win);
         }
 
         sessions.modify(session, get_self(), [&](auto& obj) {
             obj.last_update = eosio::current_time_point();
-            obj.state = static_cast<uint8_t>(state::finished);
+            obj.last_max_win = realized_win;
         });
 
-        notify_close_session(session);
-
-        if (msg.has_value())
-            emit_event(session, events::game_finished{player_win, eosio::pack(msg.value())});
-        else
-            emit_event(session, events::game_finished{player_win});
-
-        sessions.erase(session);
+        emit_event(session,
+                   events::round_finished{
+                       round_win, session.deposit + net_win, msg.has_value() ? eosio::pack(msg.value()) : bytes{}});
+    }
 
-        on_finish(current_session);
+    /* finishes continuous session with its balance */
+    void cash_out(std::optional<std::vector<param_t>>&& msg = std::nullopt) {
+        finish_session(get_session_balance(current_session), msg.has_value() ? eosio::pack(msg.value()) : bytes{});
     }
 
     // new_max_win - total payout including deposit
@@ -364,7 +543,8 @@ class game : public eosio::contract {
         eosio::check(get_token_contract(quantity) == get_first_receiver(), "transfer from incorrect contract");
         const auto& token = quantity.symbol.code().to_string();
         const auto ses_id = get_ses_id(memo);
-        eosio::check(quantity.symbol == token::get_symbol(get_platform(), token), "invalid deposit symbol");
+        eosio::check(quantity.symbol == get_token_symbol(token), "invalid deposit symbol");
+        check_session_layout();
         if (sessions.find(ses_id) == sessions.end()) {
             check_active_game();
             create_session(ses_id, from, quantity);
@@ -453,14 +633,31 @@ class game : public eosio::contract {
         const auto& session = get_session(ses_id);
 
         check_not_expired(session);
-        check_only_states(session, {state::req_signidice_part_1}, "state should be 'req_signidice_part_1'");
+
+        const auto prefetching = static_cast<prefetch>(session.prefetch) == prefetch::requested;
+        if (prefetching) {
+            check_only_states(session,
+                              {state::req_action, state::req_allow_deposit},
+                              "state should be 'req_action' or 'req_allow_deposit'");
+        } else {
+            check_only_states(session, {state::req_signidice_part_1}, "state should be 'req_signidice_part_1'");
+        }
 
         /* obtain platform's rsa key for signidice */
-        const auto& platform_rsa_key = platform::read::get_rsa_pubkey(get_platform());
+        const auto& platform_rsa_key = get_platform_rsa_key();
 
         /* check first part sign and calculate new digest */
         const auto new_digest = service::signidice(session.digest, sign, platform_rsa_key);
 
+        /* prefetched digest waits for player's action, session still waits for player */
+        if (prefetching) {
+            sessions.modify(session, get_self(), [&](auto& obj) {
+                obj.digest = new_digest;
+                obj.prefetch = static_cast<uint8_t>(prefetch::ready);
+            });
+            return;
+        }
+
         sessions.modify(session, get_self(), [&](auto& obj) {
             obj.digest = new_digest;
             obj.last_update = eosio::current_time_point();
@@ -483,7 +680,7 @@ class game : public eosio::contract {
         check_only_states(session, {state::req_signidice_part_2}, "state should be 'req_signidice_part_2'");
 
         /* obtain casino's rsa key for signidice */
-        const auto& cas_rsa_pubkey = platform::read::get_casino(get_platform(), session.casino_id).rsa_pubkey;
+        const auto& cas_rsa_pubkey = get_casino_rsa_key(session.casino_id);
 
         /* check second part sign and calculate resulting digest */
         const auto new_digest = service::signidice(session.digest, sign, cas_rsa_pubkey);
@@ -517,36 +714,53 @@ class game : public eosio::contract {
         const symbol symbol = session.deposit.symbol;
         asset player_win = asset(0, symbol);
 
-        switch (static_cast<state>(session.state)) {
-        /* if casino doesn't provide signidice we assume that casino lost */
-        case state::req_signidice_part_2:
-            player_win = session.last_max_win;
-            handle_player_win(session, player_win, "player win [session expired]");
-            break;
-
-        /* if player doesn't start game just refund deposit (here we haven't info about casino) */
-        case state::req_start:
-        /* if platform doesn't provide signidice we refund deposit to player */
-        case state::req_signidice_part_1:
-            // transfer deposit to player
-            handle_player_loss_or_tie(session, session.deposit, "refund [session expired]");
-            break;
-        /* if player haven't made first action just refund depsit */
-        case state::req_action:
-        case state::req_allow_deposit:
-            if (!session.acted) {
+        const auto* round = session_rounds.find(ses_id);
+
+        /* continuous session is settled with its balance, unfinished round is refunded */
+        if (round && static_cast<state>(session.state) != state::req_signidice_part_2) {
+            player_win = round->net_win;
+            if (player_win.amount > 0) {
+                handle_player_win(session, player_win, "cash out [session expired]");
+            } else {
+                handle_player_loss_or_tie(session, session.deposit + player_win, "cash out [session expired]");
+            }
+        } else {
+            switch (static_cast<state>(session.state)) {
+            /* if casino doesn't provide signidice we assume that casino lost */
+            case state::req_signidice_part_2:
+                player_win = session.last_max_win;
+                // continuous session behind its deposit locks no win
+                if (player_win.amount > 0) {
+                    handle_player_win(session, player_win, "player win [session expired]");
+                } else {
+                    handle_player_loss_or_tie(session, session.deposit + player_win, "refund [session expired]");
+                }
+                break;
+
+            /* if player doesn't start game just refund deposit (here we haven't info about casino) */
+            case state::req_start:
+            /* if platform doesn't provide signidice we refund deposit to player */
+            case state::req_signidice_part_1:
+                // transfer deposit to player
                 handle_player_loss_or_tie(session, session.deposit, "refund [session expired]");
                 break;
+            /* if player haven't made first action just refund depsit */
+            case state::req_action:
+            case state::req_allow_deposit:
+                if (!session.acted) {
+                    handle_player_loss_or_tie(session, session.deposit, "refund [session expired]");
+                    break;
+                }
+            /* in other cases we assume that player lost */
+            default:
+                player_win = -session.deposit;
+                handle_player_loss_or_tie(session, asset(0, symbol), "loss [session expired]");
             }
-        /* in other cases we assume that player lost */
-        default:
-            player_win = -session.deposit;
-            handle_player_loss_or_tie(session, asset(0, symbol), "loss [session expired]");
         }
 
         // if session isn't started we have no info about casino and no need to perform any action
         if (static_cast<state>(session.state) == state::req_start) {
-            sessions.erase(session);
+            erase_session(session);
             return;
         }
 
@@ -554,7 +768,7 @@ class game : public eosio::contract {
 
         emit_event(session, events::game_failed{player_win});
 
-        sessions.erase(session);
+        erase_session(session);
 
         on_finish(ses_id);
     }
@@ -568,12 +782,56 @@ class game : public eosio::contract {
         global.platform = platform;
         global.events = events;
         global.session_ttl = session_ttl;
+        // game upgraded from previous SDK version could have sessions of legacy layout
+        if (!global.session_layout.has_value() && global.session_seq == 0u) {
+            global.session_layout.emplace(session_layout_version);
+        }
 
         on_init();
     }
 
+    /*
+     Converts sessions of games deployed before params snapshots to current layout,
+     should be pushed right after contract upgrade, sessions are unavailable until then.
+     All sessions are converted at once, so upgrade is better done with few live sessions.
+    */
+    CONTRACT_ACTION(migrate)
+    void migrate() {
+        require_auth(get_self());
+        eosio::check(global.session_layout.value_or(0u) != session_layout_version, "sessions are already migrated");
+
+        legacy_session_table legacy_sessions(_self, _self.value);
+        const std::vector<legacy_session_row> rows(legacy_sessions.begin(), legacy_sessions.end());
+
+        for (const auto& row : rows) {
+            legacy_sessions.erase(legacy_sessions.find(row.ses_id));
+
+            // session isn't started yet if it has no params
+            const auto params_id = row.params.empty() ? 0u : acquire_params(row.casino_id, row.token, row.params);
+            sessions.emplace(get_self(), [&](auto& obj) {
+                obj.ses_id = row.ses_id;
+                obj.casino_id = row.casino_id;
+                obj.ses_seq = row.ses_seq;
+                obj.player = row.player;
+                obj.state = row.state;
+                obj.params_id = params_id;
+                obj.token = row.token;
+                obj.deposit = row.deposit;
+                obj.bonus_deposit = row.bonus_deposit;
+                obj.digest = row.digest;
+                obj.last_update = row.last_update;
+                obj.last_max_win = row.last_max_win;
+                obj.acted = row.acted;
+                obj.prefetch = static_cast<uint8_t>(prefetch::none);
+            });
+        }
+
+        global.session_layout.emplace(session_layout_version);
+    }
+
   private:
     const session_row& create_session(uint64_t ses_id, name player, asset deposit) {
+        check_session_layout();
         return *sessions.emplace(get_self(), [&](auto& row) {
             row.ses_id = ses_id;
             row.ses_seq = global.session_seq++;
@@ -584,10 +842,58 @@ class game : public eosio::contract {
             row.last_update = eosio::current_time_point();
             row.last_max_win = asset(0, deposit.symbol);
             row.state = static_cast<uint8_t>(state::req_start);
+            row.params_id = 0u;
+            row.prefetch = static_cast<uint8_t>(prefetch::none);
         });
     }
 
+    /* returns id of params snapshot, the same params share single snapshot */
+    uint64_t acquire_params(uint64_t casino_id, const std::string& token, const game_params_type& params) {
+        const auto packed = eosio::pack(std::make_tuple(casino_id, token, params));
+        const auto hash = eosio::sha256(packed.data(), packed.size());
+
+        auto by_hash = params_snapshots.get_index<"hash"_n>();
+        for (auto it = by_hash.find(hash); it != by_hash.end() && it->hash == hash; ++it) {
+            if (it->casino_id == casino_id && it->token == token && it->params == params) {
+                by_hash.modify(it, get_self(), [&](auto& row) { row.ref_count++; });
+                return it->id;
+            }
+        }
+
+        // zero id means session without snapshot
+        const auto id = std::max<uint64_t>(params_snapshots.available_primary_key(), 1u);
+        params_snapshots.emplace(get_self(), [&](auto& row) {
+            row.id = id;
+            row.casino_id = casino_id;
+            row.token = token;
+            row.params = params;
+            row.hash = hash;
+            row.ref_count = 1u;
+        });
+        return id;
+    }
+
+    void release_params(uint64_t params_id) {
+        if (params_id == 0u) {
+            return;
+        }
+        const auto& snapshot = params_snapshots.get(params_id, "session params not found");
+        if (snapshot.ref_count > 1u) {
+            params_snapshots.modify(snapshot, get_self(), [&](auto& row) { row.ref_count--; });
+        } else {
+            params_snapshots.erase(snapshot);
+        }
+    }
+
+    void erase_session(const session_row& session) {
+        on_erase_session(session.ses_id);
+        release_params(session.params_id);
+        session_rounds.release(session.ses_id);
+        sessions.erase(session);
+    }
+
     const session_row& get_or_create_session(uint64_t ses_id, name player, asset deposit) {
+        check_session_layout();
         if (sessions.find(ses_id) == sessions.end()) {
             return create_session(ses_id, player, deposit);
         }
@@ -624,7 +930,7 @@ class game : public eosio::contract {
             verify_token_casino(session.deposit, casino_id);
         }
 
-        const auto game_params = fetch_game_params(casino_id);
+        const auto params_id = acquire_params(casino_id, session.token, fetch_game_params(casino_id));
         const auto init_digest = calc_seed(casino_id, session.ses_seq, session.player);
 
         // always be careful with ref after modify
@@ -633,7 +939,7 @@ class game : public eosio::contract {
             obj.last_update = eosio::current_time_point();
             obj.casino_id = casino_id;
             obj.digest = init_digest;
-            obj.params = game_params;
+            obj.params_id = params_id;
         });
 
         // update session ref (invalidates after modify)
@@ -649,46 +955,65 @@ class game : public eosio::contract {
 
   private:
     session_table sessions;
+    params_table params_snapshots;
+    round_table session_rounds;
     global_row global;
     uint64_t current_session; // id of session for which was called action
 
   private:
+    /* pays `player_payout` and finishes current session */
+    void finish_session(asset player_payout, bytes&& msg) {
+        const auto& session = get_session(current_session);
+
+        check_only_states(session,
+                          {state::req_action, state::req_signidice_part_2},
+                          "state should be 'req_signidice_part_2' or 'req_action'");
+        eosio::check(session.token == player_payout.symbol.code().to_string(), "incorrect player_payout token");
+        // player_payout is total payout, here we calculate player profit
+        const auto player_win = player_payout - session.deposit;
+        eosio::check(player_win <= session.last_max_win, "player win should be less than 'last_max_win'");
+
+        if (player_win.amount > 0) {
+            handle_player_win(session, player_win);
+        } else {
+            handle_player_loss_or_tie(session, player_payout);
+        }
+
+        sessions.modify(session, get_self(), [&](auto& obj) {
+            obj.last_update = eosio::current_time_point();
+            obj.state = static_cast<uint8_t>(state::finished);
+        });
+
+        notify_close_session(session);
+
+        emit_event(session, events::game_finished{player_win, std::move(msg)});
+
+        erase_session(session);
+
+        on_finish(current_session);
+    }
+
     template <typename Event> void emit_event(const session_row& ses, const Event& event) {
+        static_assert(events::registry::contains<Event> || event_type<Event>() >= first_custom_event_type,
+                      "SDK event should be in events::registry");
+        static_assert(event_type<Event>() < max_event_type, "event type should be below max_event_type");
+
         const auto data_bytes = eosio::pack<Event>(event);
 
         eosio::action({get_self(), "active"_n},
                       get_events(),
                       "send"_n,
-                      std::make_tuple(get_self(), ses.casino_id, get_self_id(), ses.ses_id, event.type, data_bytes))
+                      std::make_tuple(
+                          get_self(), ses.casino_id, get_self_id(), ses.ses_id, event_type<Event>(), data_bytes))
             .send();
     }
 
     uint64_t get_ses_id(const std::string& str) const { return std::stoull(str); }
 
-    uint64_t get_self_id() const { return platform::read::get_game(get_platform(), get_self()).id; }
-
     name get_platform() const { return global.platform; }
 
     name get_events() const { return global.events; }
 
-    name get_casino(const uint64_t casino_id) const {
-        return platform::read::get_casino(get_platform(), casino_id).contract;
-    }
-
-    game_params_type fetch_game_params(const uint64_t casino_id) const {
-        const auto& session = get_session(current_session);
-        const auto casino = get_casino(casino_id);
-        const auto token_raw = platform::get_token_pk(session.token);
-        casino::game_params_table game_params(casino, casino.value);
-        if (game_params.find(get_self_id()) == game_params.end() && token_raw == core_symbol.code().raw()) {
-            casino::game_table casino_games(casino, casino.value);
-            return casino_games.get(get_self_id()).params;
-        }
-        const auto& params_map = game_params.get(get_self_id(), "game is not in game params").params;
-        eosio::check(params_map.find(token_raw) != params_map.end(), "token is not allowed for this game");
-        return params_map.at(token_raw);
-    }
-
     bool is_expired(const session_row& ses) const {
         return eosio::current_time_point().sec_since_epoch() - ses.last_update.sec_since_epoch() > global.session_ttl;
     }
@@ -830,10 +1155,9 @@ class game : public eosio::contract {
 
     void set_current_session(uint64_t ses_id) { current_session = ses_id; }
 
-    name get_token_contract(asset quantity) const {
-        platform::token_table tokens(get_platform(), get_platform().value);
-        auto token_it = tokens.require_find(quantity.symbol.code().raw(), "token is not in the list");
-        return token_it->contract;
+    void check_session_layout() const {
+        eosio::check(global.session_layout.value_or(0u) == session_layout_version,
+                     "sessions should be migrated by 'migrate' action after SDK upgrade");
     }
 
   private:
@@ -853,6 +1177,44 @@ class game : public eosio::contract {
 
     void check_not_expired(const session_row& ses) const { eosio::check(!is_expired(ses), "session expired"); }
 
+    void check_from_platform_game() const { require_auth({get_platform(), platform_game_permission}); }
+
+  private:
+    /* platform and casino readers */
+    uint64_t get_self_id() const { return platform::read::get_game(get_platform(), get_self()).id; }
+
+    name get_casino(const uint64_t casino_id) const {
+        return platform::read::get_casino(get_platform(), casino_id).contract;
+    }
+
+    game_params_type fetch_game_params(const uint64_t casino_id) const {
+        const auto& session = get_session(current_session);
+        const auto casino = get_casino(casino_id);
+        const auto token_raw = platform::get_token_pk(session.token);
+        casino::game_params_table game_params(casino, casino.value);
+        if (game_params.find(get_self_id()) == game_params.end() && token_raw == core_symbol.code().raw()) {
+            casino::game_table casino_games(casino, casino.value);
+            return casino_games.get(get_self_id()).params;
+        }
+        const auto& params_map = game_params.get(get_self_id(), "game is not in game params").params;
+        eosio::check(params_map.find(token_raw) != params_map.end(), "token is not allowed for this game");
+        return params_map.at(token_raw);
+    }
+
+    name get_token_contract(asset quantity) const {
+        platform::token_table tokens(get_platform(), get_platform().value);
+        auto token_it = tokens.require_find(quantity.symbol.code().raw(), "token is not in the list");
+        return token_it->contract;
+    }
+
+    symbol get_token_symbol(const std::string& token) const { return token::get_symbol(get_platform(), token); }
+
+    std::string get_platform_rsa_key() const { return platform::read::get_rsa_pubkey(get_platform()); }
+
+    std::string get_casino_rsa_key(const uint64_t casino_id) const {
+        return platform::read::get_casino(get_platform(), casino_id).rsa_pubkey;
+    }
+
     void check_active_game() const {
         eosio::check(platform::read::is_active_game(get_platform(), get_self_id()), "game is't active in platform");
     }
@@ -868,8 +1230,6 @@ class game : public eosio::contract {
         eosio::check(platform::read::is_active_casino(get_platform(), casino_id), "casino is't active in platform");
     }
 
-    void check_from_platform_game() const { require_auth({get_platform(), platform_game_permission}); }
-
     void verify_token_casino(asset amount, uint64_t casino_id) {
         const name casino = get_casino(casino_id);
         casino::token_table tokens(casino, casino.value);
@@ -906,6 +1266,6 @@ class game : public eosio::contract {
 #endif
 };
 
-const asset game::zero_asset = asset(0, game::core_symbol);
+inline const asset game::zero_asset = asset(0, game::core_symbol);
 
 } // namespace game_sdk
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <intx/int128.hpp>
+
+namespace service::payout_math {
+
+/* x * y / z rounded down, product is kept in 128 bits, so only result should fit in 64 bits */
+inline uint64_t muldiv(uint64_t x, uint64_t y, uint64_t z) {
+    eosio::check(z != 0, "muldiv: division by zero");
+    const auto product = intx::umul(x, y);
+    eosio::check(product.hi < z, "muldiv: result overflow");
+    return (product / intx::uint128(z)).lo;
+}
+
+/**
+   Amounts moved on session finish, in session token units.
+   Deposit and payouts are split between real tokens and bonus in proportion of session's bonus deposit,
+   bonus share is rounded down, so rounding remainder always goes to real part.
+*/
+struct settlement {
+    int64_t real_win{0};     // casino -> player, real tokens
+    int64_t bonus_payout{0}; // casino -> player, bonus including returned bonus deposit
+    int64_t real_refund{0};  // game -> player, real part of deposit
+    int64_t casino_win{0};   // game -> casino, lost real part of deposit
+
+    /* real tokens player receives */
+    int64_t real_payout() const { return real_refund + real_win; }
+};
+
+namespace detail {
+inline void check_amounts(int64_t deposit, int64_t bonus_deposit) {
+    eosio::check(deposit > 0, "invariant check failed: deposit should be positive");
+    eosio::check(bonus_deposit >= 0 && bonus_deposit <= deposit,
+                 "invariant check failed: bonus deposit should be within deposit");
+}
+} // namespace detail
+
+/* player's profit `win` over whole deposit */
+inline settlement settle_win(int64_t deposit, int64_t bonus_deposit, int64_t win) {
+    detail::check_amounts(deposit, bonus_deposit);
+    eosio::check(win > 0, "invariant check failed: player win should be positive");
+
+    const auto bonus_win = int64_t(muldiv(win, bonus_deposit, deposit));
+
+    settlement result;
+    result.real_win = win - bonus_win;
+    result.bonus_payout = bonus_deposit + bonus_win;
+    result.real_refund = deposit - bonus_deposit;
+    return result;
+}
+
+/* player's total `payout` not exceeding deposit, the rest of real deposit is won by casino */
+inline settlement settle_loss(int64_t deposit, int64_t bonus_deposit, int64_t payout) {
+    detail::check_amounts(deposit, bonus_deposit);
+    eosio::check(payout >= 0 && payout <= deposit, "invariant check failed: player payout cannot exceed deposit");
+
+    settlement result;
+    result.bonus_payout = int64_t(muldiv(payout, bonus_deposit, deposit));
+    result.real_refund = payout - result.bonus_payout;
+    result.casino_win = deposit - bonus_deposit - result.real_refund;
+
+    // bonus share is rounded down, so real refund never exceeds real deposit
+    eosio::check(result.casino_win >= 0, "invariant check failed: casino win should be non-negative");
+    return result;
+}
+
+} // namespace service::payout_math
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <limits>
+
+#include <eosio/eosio.hpp>
+#include <eosio/multi_index.hpp>
+
+namespace game_sdk {
+
+/**
+   Per-session game table which reuses rows of finished sessions instead of erase/emplace pair,
+   so RAM billing and primary index stay untouched for every new session.
+
+   Row is keyed by `slot`, session id is secondary key:
+        struct [[eosio::table("roll")]] roll_row {
+            uint64_t slot;
+            uint64_t ses_id;
+            uint32_t number;
+
+            uint64_t primary_key() const { return slot; }
+            uint64_t by_ses_id() const { return ses_id; }
+        };
+        using roll_table = game_sdk::recycled_table<"roll"_n, roll_row>;
+
+   Released rows get `free_ses_id` and are reset to default values, so secondary index works as free list.
+   Rows should have fixed size to avoid RAM delta on reuse.
+*/
+template <eosio::name::raw TableName, typename T> class recycled_table {
+  public:
+    static constexpr uint64_t free_ses_id = std::numeric_limits<uint64_t>::max();
+
+    using table_type = eosio::multi_index<
+        TableName,
+        T,
+        eosio::indexed_by<"sesid"_n, eosio::const_mem_fun<T, uint64_t, &T::by_ses_id>>>;
+
+  public:
+    recycled_table(eosio::name code, uint64_t scope) : _table(code, scope) {}
+
+    /* takes free row or creates new one, `updater` shouldn't change `slot` and `ses_id` */
+    template <typename Lambda> const T& emplace(eosio::name payer, uint64_t ses_id, Lambda&& updater) {
+        eosio::check(ses_id != free_ses_id, "invalid ses_id");
+        eosio::check(!find(ses_id), "row with this ses_id already exists");
+
+        auto by_ses_id = _table.template get_index<"sesid"_n>();
+        const auto free_itr = by_ses_id.find(free_ses_id);
+        if (free_itr != by_ses_id.end()) {
+            const auto& row = *free_itr;
+            _table.modify(row, payer, [&](T& obj) {
+                obj.ses_id = ses_id;
+                updater(obj);
+            });
+            check_keys(row, ses_id);
+            return row;
+        }
+
+        const auto slot = _table.available_primary_key();
+        const auto itr = _table.emplace(payer, [&](T& obj) {
+            obj.slot = slot;
+            obj.ses_id = ses_id;
+            updater(obj);
+        });
+        check_keys(*itr, ses_id);
+        return *itr;
+    }
+
+    const T* find(uint64_t ses_id) const {
+        auto by_ses_id = _table.template get_index<"sesid"_n>();
+        const auto itr = by_ses_id.find(ses_id);
+        return itr != by_ses_id.end() ? &*itr : nullptr;
+    }
+
+    const T& get(uint64_t ses_id, const char* error_msg = "unable to find row with this ses_id") const {
+        const auto* row = find(ses_id);
+        eosio::check(row != nullptr, error_msg);
+        return *row;
+    }
+
+    template <typename Lambda> void modify(const T& row, eosio::name payer, Lambda&& updater) {
+        const auto ses_id = row.ses_id;
+        _table.modify(row, payer, std::forward<Lambda>(updater));
+        check_keys(row, ses_id);
+    }
+
+    /* marks row of session as free, does nothing if session has no row */
+    void release(uint64_t ses_id) {
+        const auto* row = find(ses_id);
+        if (!row) {
+            return;
+        }
+        _table.modify(*row, eosio::same_payer, [&](T& obj) {
+            const auto slot = obj.slot;
+            obj = T{};
+            obj.slot = slot;
+            obj.ses_id = free_ses_id;
+        });
+    }
+
+    /* underlying table, free rows are included */
+    const table_type& raw() const { return _table; }
+
+  private:
+    static void check_keys(const T& row, uint64_t ses_id) {
+        eosio::check(row.ses_id == ses_id, "updater cannot change ses_id");
+    }
+
+  private:
+    table_type _table;
+};
+
+} // namespace game_sdk
@@ -28,7 +28,7 @@ namespace daobet {
 /**
    C++ version of RSA sign verification function
 */
-bool rsa_verify(const eosio::checksum256& digest, const std::string& sig, const std::string& pubkey) {
+inline bool rsa_verify(const eosio::checksum256& digest, const std::string& sig, const std::string& pubkey) {
     auto digest_data = digest.extract_as_byte_array();
     return ::rsa_verify(reinterpret_cast<const capi_checksum256*>(digest_data.data()),
                         sig.c_str(),
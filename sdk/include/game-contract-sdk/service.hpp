@@ -22,7 +22,7 @@ T cut_to(const checksum256& input) {
     return cut_to<uint128_t>(input) % std::numeric_limits<T>::max();
 }
 
-template <> uint128_t cut_to(const checksum256& input) {
+template <> inline uint128_t cut_to(const checksum256& input) {
     const auto& parts = input.get_array();
     const uint128_t left = parts[0] % std::numeric_limits<uint64_t>::max();
     const uint128_t right = parts[1] % std::numeric_limits<uint64_t>::max();
@@ -30,7 +30,7 @@ template <> uint128_t cut_to(const checksum256& input) {
     return (left << (sizeof(uint64_t) * 8)) | right;
 }
 
-std::array<uint64_t, 4> split(const checksum256& raw) {
+inline std::array<uint64_t, 4> split(const checksum256& raw) {
     const auto& parts = raw.get_array();
     return std::array<uint64_t, 4>{
         uint64_t(parts[0] >> 64),
@@ -41,6 +41,44 @@ std::array<uint64_t, 4> split(const checksum256& raw) {
 }
 
 
+// ===================================================================
+// Exact range reduction of PRNG seed
+// ===================================================================
+namespace detail {
+/* Lemire's multiply-shift over 64-bit words of digest, word is rejected if `accept(low part)` fails */
+template <typename Accept> uint64_t uniform_reduce(checksum256 digest, uint64_t n, Accept&& accept) {
+    for (;;) {
+        for (const auto word : split(digest)) {
+            const auto product = uint128_t(word) * n;
+            if (accept(uint64_t(product))) {
+                return uint64_t(product >> 64);
+            }
+        }
+        // all four words are rejected, probability is below (n / 2^64)^4
+        const auto bytes = digest.extract_as_byte_array();
+        digest = eosio::sha256(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+}
+} // namespace detail
+
+/**
+   Uniform number in [0, n) from digest, unlike `cut_to` keeps distribution exact.
+   Words of digest are taken from most significant one, rejected word is replaced by the next one,
+   rejection threshold is calculated only in rare case when low part of product is less than `n`.
+*/
+inline uint64_t uniform(const checksum256& digest, uint64_t n) {
+    eosio::check(n > 0, "invalid random range");
+    return detail::uniform_reduce(digest, n, [n](uint64_t low) { return low >= n || low >= (0 - n) % n; });
+}
+
+/* Uniform number in [0, N) with compile time threshold, powers of two are never rejected */
+template <uint64_t N> uint64_t uniform(const checksum256& digest) {
+    static_assert(N > 0, "invalid random range");
+    constexpr uint64_t threshold = (0 - N) % N;
+    return detail::uniform_reduce(digest, N, [](uint64_t low) { return low >= threshold; });
+}
+
+
 // ===================================================================
 // Different PRNG implementations
 // ===================================================================
@@ -72,19 +110,23 @@ class ShaMixWithRejection : public PRNG {
         eosio::check(to > from, "invalid random range");
         eosio::check(_cur_iter < UINT32_MAX, "too many next() calls");
 
-        const intx::uint256 delta(to - from);
-        const intx::uint256 cut_threshold = UINT256_MAX / delta * delta;
+        // shuffles and card draws use the same range many times, so divisor is kept for next calls
+        if (to - from != _delta) {
+            _delta = to - from;
+            _divisor = intx::divisor64(_delta);
+            _cut_threshold = UINT256_MAX - UINT256_MAX % _divisor; // the largest multiple of delta
+        }
 
         auto lucky_as_hash = mix_bytes();
         auto lucky = to_intx(lucky_as_hash);
 
-        while (lucky >= cut_threshold) {
+        while (lucky >= _cut_threshold) {
             auto lucky_bytes = lucky_as_hash.extract_as_byte_array();
             lucky_as_hash = eosio::sha256(reinterpret_cast<const char*>(lucky_bytes.data()), 32);
             lucky = to_intx(lucky_as_hash);
         }
 
-        return uint64_t(lucky % delta + from);
+        return lucky % _divisor + from;
     }
 
   private:
@@ -112,6 +154,10 @@ class ShaMixWithRejection : public PRNG {
   private:
     const intx::uint256 _s;
     uint32_t _cur_iter { 0u };
+
+    uint64_t _delta { 1u };
+    intx::divisor64 _divisor { 1u };
+    intx::uint256 _cut_threshold { UINT256_MAX };
 };
 
 /**
@@ -168,7 +214,7 @@ void shuffle(RandomIt first, RandomIt last, PRNG::Ptr& prng) {
     - pub_key - base64 encoded 2048-bit RSA public key
    Returns - new 256-bit digest calculated from sign
 */
-checksum256 signidice(const checksum256& prev_digest, const std::string& sign, const std::string& rsa_key) {
+inline checksum256 signidice(const checksum256& prev_digest, const std::string& sign, const std::string& rsa_key) {
     eosio::check(daobet::rsa_verify(prev_digest, sign, rsa_key), "invalid rsa signature");
 
     return eosio::sha256(sign.data(), sign.size());
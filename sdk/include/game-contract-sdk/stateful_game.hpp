@@ -0,0 +1,127 @@
+#pragma once
+
+#include <optional>
+
+#include <game-contract-sdk/game_base.hpp>
+
+#ifdef GAME_SDK_NATIVE
+#include <exception>
+#endif
+
+namespace game_sdk {
+
+/**
+   Game with typed per-session state managed by SDK.
+   State is kept in `gamestate` table keyed by ses_id, it's loaded once per action on first access
+   and stored on action end like global singleton, row is erased together with session on finish or close.
+
+        struct dice_state {
+            uint32_t number;
+            EOSLIB_SERIALIZE(dice_state, (number))
+        };
+        class [[eosio::contract]] dice : public game_sdk::stateful_game<dice_state> { ... };
+
+   State is default constructed for session without stored state.
+   State table isn't described in ABI, rows are decoded by game's own types.
+*/
+template <typename State> class stateful_game : public game {
+  public:
+    struct state_row {
+        uint64_t ses_id;
+        State state;
+
+        uint64_t primary_key() const { return ses_id; }
+
+        EOSLIB_SERIALIZE(state_row, (ses_id)(state))
+    };
+
+    using state_table = eosio::multi_index<"gamestate"_n, state_row>;
+
+  public:
+    stateful_game(name receiver, name code, eosio::datastream<const char*> ds)
+        : game(receiver, code, ds), states(_self, _self.value) {}
+
+    virtual ~stateful_game() {
+#ifdef GAME_SDK_NATIVE
+        // failed action is reverted by host, nothing to store
+        if (std::uncaught_exceptions() > 0) {
+            return;
+        }
+#endif
+        flush_state();
+    }
+
+  protected:
+    /* state of session, available in `on_finish` too */
+    const State& get_state(uint64_t ses_id) { return load_state(ses_id).state; }
+
+    /* mutable state of session, stored on action end */
+    State& modify_state(uint64_t ses_id) {
+        auto& cached = load_state(ses_id);
+        cached.dirty = true;
+        return cached.state;
+    }
+
+    void on_erase_session(uint64_t ses_id) override {
+        if (!cache || cache->ses_id != ses_id) {
+            load_state(ses_id);
+        }
+        cache->erased = true;
+    }
+
+  private:
+    struct cached_state {
+        uint64_t ses_id;
+        State state;
+        bool stored{false}; // <- row exists in table
+        bool dirty{false};
+        bool erased{false}; // <- session is erased, row should be removed
+    };
+
+    cached_state& load_state(uint64_t ses_id) {
+        if (cache && cache->ses_id == ses_id) {
+            return *cache;
+        }
+        // action works with single session, other session's state is stored at once
+        flush_state();
+
+        cache.emplace();
+        cache->ses_id = ses_id;
+        if (const auto itr = states.find(ses_id); itr != states.end()) {
+            cache->state = itr->state;
+            cache->stored = true;
+        } else {
+            cache->state = State{};
+        }
+        return *cache;
+    }
+
+    void flush_state() {
+        if (!cache) {
+            return;
+        }
+
+        if (cache->erased) {
+            if (cache->stored) {
+                states.erase(states.get(cache->ses_id));
+            }
+        } else if (cache->dirty) {
+            const auto updater = [&](auto& row) {
+                row.ses_id = cache->ses_id;
+                row.state = cache->state;
+            };
+            if (cache->stored) {
+                states.modify(states.get(cache->ses_id), get_self(), updater);
+            } else {
+                states.emplace(get_self(), updater);
+            }
+        }
+        cache.reset();
+    }
+
+  private:
+    state_table states;
+    std::optional<cached_state> cache;
+};
+
+} // namespace game_sdk
@@ -287,7 +287,11 @@ constexpr uint128 constexpr_umul(uint64_t x, uint64_t y) noexcept
 /// Full unsigned multiplication 64 x 64 -> 128.
 inline uint128 umul(uint64_t x, uint64_t y) noexcept
 {
-#if defined(__SIZEOF_INT128__)
+#if defined(__wasm__)
+    // WASM has no wide multiplication, __int128 product is lowered to __multi3() call,
+    // while 32-bit limbs take only native i64 operations.
+    return constexpr_umul(x, y);
+#elif defined(__SIZEOF_INT128__)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
     const auto p = static_cast<unsigned __int128>(x) * y;
@@ -440,11 +444,11 @@ inline uint128 bswap(uint128 x) noexcept
 /// Division.
 /// @{
 
-template <typename T>
+template <typename QuotT, typename RemT = QuotT>
 struct div_result
 {
-    T quot;
-    T rem;
+    QuotT quot;
+    RemT rem;
 };
 
 namespace internal
@@ -474,11 +478,52 @@ constexpr uint16_t reciprocal_table[] = {REPEAT256()};
 #undef REPEAT256
 }  // namespace internal
 
+/// Divides 128-bit u by normalized 64-bit d using 32-bit limbs, u.hi must be less than d.
+///
+/// Based on divlu() from "Hacker's Delight", every quotient limb is estimated by native
+/// 64-bit division of the top limbs and corrected at most twice.
+constexpr div_result<uint64_t> udivrem_norm_2by1(uint128 u, uint64_t d) noexcept
+{
+    constexpr auto base = uint64_t{1} << 32;
+    const auto dh = d >> 32;
+    const auto dl = d & 0xffffffff;
+    const auto u1 = u.lo >> 32;
+    const auto u0 = u.lo & 0xffffffff;
+
+    auto q1 = u.hi / dh;
+    auto r = u.hi - q1 * dh;
+    while (q1 >= base || q1 * dl > ((r << 32) | u1))
+    {
+        --q1;
+        r += dh;
+        if (r >= base)
+            break;
+    }
+
+    const auto u21 = (u.hi << 32) + u1 - q1 * d;
+
+    auto q0 = u21 / dh;
+    r = u21 - q0 * dh;
+    while (q0 >= base || q0 * dl > ((r << 32) | u0))
+    {
+        --q0;
+        r += dh;
+        if (r >= base)
+            break;
+    }
+
+    return {(q1 << 32) | q0, (u21 << 32) + u0 - q0 * d};
+}
+
 /// Computes the reciprocal (2^128 - 1) / d - 2^64 for normalized d.
 ///
 /// Based on Algorithm 2 from "Improved division by invariant integers".
 inline uint64_t reciprocal_2by1(uint64_t d) noexcept
 {
+#if defined(__wasm__)
+    // The table based approximation takes several wide multiplications.
+    return udivrem_norm_2by1({~d, ~uint64_t{0}}, d).quot;
+#else
     auto d9 = uint8_t(d >> 55);
     auto v0 = uint64_t{internal::reciprocal_table[d9]};
 
@@ -503,6 +548,7 @@ inline uint64_t reciprocal_2by1(uint64_t d) noexcept
     auto v4 = v3 - v3a;
 
     return v4;
+#endif
 }
 
 inline uint64_t reciprocal_3by2(uint128 d) noexcept
@@ -535,6 +581,11 @@ inline uint64_t reciprocal_3by2(uint128 d) noexcept
 
 inline div_result<uint64_t> udivrem_2by1(uint128 u, uint64_t d, uint64_t v) noexcept
 {
+#if defined(__wasm__)
+    // Native 64-bit division is cheaper than multiplication by the reciprocal.
+    (void)v;
+    return udivrem_norm_2by1(u, d);
+#else
     auto q = umul(v, u.hi);
     q = fast_add(q, u);
 
@@ -555,6 +606,7 @@ inline div_result<uint64_t> udivrem_2by1(uint128 u, uint64_t d, uint64_t v) noex
     }
 
     return {q.hi, r};
+#endif
 }
 
 inline div_result<uint128> udivrem_3by2(
@@ -787,6 +787,60 @@ constexpr uint<N>& operator%=(uint<N>& x, const T& y) noexcept
     return x = x % y;
 }
 
+/// The 64-bit divisor prepared for repeated division of long integers.
+///
+/// The normalization shift and the reciprocal are computed once,
+/// so every division by it takes only udivrem_2by1() steps.
+struct divisor64
+{
+    uint64_t normalized;  ///< The divisor shifted to have the top bit set.
+    uint64_t reciprocal;  ///< The reciprocal_2by1() of the normalized divisor.
+    unsigned shift;       ///< The normalization shift.
+
+    /// Prepares the divisor, d must not be zero.
+    explicit divisor64(uint64_t d) noexcept
+      : normalized{d << clz(d)}, reciprocal{reciprocal_2by1(normalized)}, shift{clz(d)}
+    {}
+};
+
+/// Divides long unsigned integer by the prepared 64-bit divisor.
+///
+/// The numerator is normalized word by word on the fly, the word shifted out of the top one
+/// is the initial remainder and it is always less than the normalized divisor.
+template <unsigned N>
+inline div_result<uint<N>, uint64_t> udivrem(const uint<N>& u, const divisor64& d) noexcept
+{
+    constexpr int num_words = uint<N>::num_words;
+    const auto* uw = as_words(u);
+    const auto s = d.shift;
+
+    uint<N> q;
+    auto* qw = as_words(q);
+
+    uint64_t r = s != 0 ? uw[num_words - 1] >> (64 - s) : 0;
+    for (int j = num_words - 1; j >= 0; --j)
+    {
+        const uint64_t carry = (s != 0 && j > 0) ? uw[j - 1] >> (64 - s) : 0;
+        const auto x = udivrem_2by1({r, (uw[j] << s) | carry}, d.normalized, d.reciprocal);
+        qw[j] = x.quot;
+        r = x.rem;
+    }
+
+    return {q, r >> s};
+}
+
+template <unsigned N>
+inline uint<N> operator/(const uint<N>& x, const divisor64& d) noexcept
+{
+    return udivrem(x, d).quot;
+}
+
+template <unsigned N>
+inline uint64_t operator%(const uint<N>& x, const divisor64& d) noexcept
+{
+    return udivrem(x, d).rem;
+}
+
 template <unsigned N>
 inline uint<N> bswap(const uint<N>& x) noexcept
 {
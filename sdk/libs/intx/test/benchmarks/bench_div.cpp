@@ -127,3 +127,46 @@ BENCHMARK_TEMPLATE(udiv64, udiv_by_reciprocal);
 BENCHMARK_TEMPLATE(udiv64, udiv_native);
 BENCHMARK_TEMPLATE(udiv64, soft_div_unr);
 BENCHMARK_TEMPLATE(udiv64, soft_div_unr_unrolled);
+
+/// Remainders of 256-bit numbers by the same 64-bit divisor, like in PRNG rejection sampling.
+template <typename Fn>
+static void mod256_by64(benchmark::State& state, Fn fn)
+{
+    lcg<uint256> rng{get_seed()};
+    std::vector<uint256> input(1000);
+    for (auto& x : input)
+        x = rng();
+    const auto d = static_cast<uint64_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        uint64_t x = 0;
+        for (const auto& u : input)
+            x ^= fn(u, d);
+        benchmark::DoNotOptimize(x);
+    }
+}
+BENCHMARK_CAPTURE(mod256_by64, generic, [](const uint256& u, uint64_t d) {
+    return static_cast<uint64_t>(u % d);
+})->Arg(100)->Arg(uint64_t{3} << 30)->Arg(~uint64_t{0} >> 1);
+BENCHMARK_CAPTURE(mod256_by64, divisor64, [](const uint256& u, uint64_t d) {
+    return u % divisor64{d};
+})->Arg(100)->Arg(uint64_t{3} << 30)->Arg(~uint64_t{0} >> 1);
+
+static void mod256_by64_reused(benchmark::State& state)
+{
+    lcg<uint256> rng{get_seed()};
+    std::vector<uint256> input(1000);
+    for (auto& x : input)
+        x = rng();
+    const auto d = divisor64{static_cast<uint64_t>(state.range(0))};
+
+    for (auto _ : state)
+    {
+        uint64_t x = 0;
+        for (const auto& u : input)
+            x ^= u % d;
+        benchmark::DoNotOptimize(x);
+    }
+}
+BENCHMARK(mod256_by64_reused)->Arg(100)->Arg(uint64_t{3} << 30)->Arg(~uint64_t{0} >> 1);
@@ -189,6 +189,27 @@ TEST(div, udivrem_512)
     }
 }
 
+TEST(div, udivrem_by_divisor64)
+{
+    for (auto& t : div_test_cases)
+    {
+        if (t.denominator > ~uint64_t{0})
+            continue;
+
+        const auto d = divisor64{static_cast<uint64_t>(t.denominator)};
+        auto res = udivrem(t.numerator, d);
+        EXPECT_EQ(res.quot, t.quotient);
+        EXPECT_EQ(res.rem, t.reminder);
+    }
+
+    constexpr auto max = ~uint256{0};
+    for (const auto d : {uint64_t{1}, uint64_t{2}, uint64_t{3}, uint64_t{100}, uint64_t{1} << 63, ~uint64_t{0}})
+    {
+        const auto divisor = divisor64{d};
+        EXPECT_EQ(max / divisor, max / d) << d;
+        EXPECT_EQ(max % divisor, max % d) << d;
+    }
+}
 
 static div_test_case<uint256> sdivrem_test_cases[] = {
     {13_u256, 3_u256, 4_u256, 1_u256},
@@ -374,6 +374,29 @@ TEST(int128, umul_random)
     }
 }
 
+TEST(int128, udivrem_norm_2by1_random)
+{
+    const auto inputs = gen_uniform_seq(10000);
+
+    for (size_t i = 2; i < inputs.size(); ++i)
+    {
+        const auto d = inputs[i - 2] | (uint64_t{1} << 63);
+        const auto u = uint128{inputs[i - 1] % d, inputs[i]};
+
+        const auto expected = intx::udivrem_2by1(u, d, intx::reciprocal_2by1(d));
+        const auto res = intx::udivrem_norm_2by1(u, d);
+
+        EXPECT_EQ(res.quot, expected.quot) << u.hi << ":" << u.lo << " / " << d;
+        EXPECT_EQ(res.rem, expected.rem) << u.hi << ":" << u.lo << " / " << d;
+    }
+
+    // the largest quotient
+    const auto d = ~uint64_t{0};
+    const auto res = intx::udivrem_norm_2by1({d - 1, ~uint64_t{0}}, d);
+    EXPECT_EQ(res.quot, ~uint64_t{0});
+    EXPECT_EQ(res.rem, d - 1);
+}
+
 TEST(int128, clz)
 {
     EXPECT_EQ(clz(intx::uint128{0}), 128);
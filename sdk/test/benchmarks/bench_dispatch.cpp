@@ -0,0 +1,31 @@
+#include <game_simulator/simulator.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr eosio::name game_name = "benchgame"_n;
+
+/* `execute_action` dispatch: args decoding, game construction and global singleton store */
+void execute_action_init(benchmark::State& state) {
+    game_sim::simulator sim(game_name, {}, 0u);
+
+    for (auto _ : state) {
+        sim.push_action("init"_n, game_sim::simulator::platform_name, game_sim::simulator::events_name, 600u);
+    }
+}
+BENCHMARK(execute_action_init);
+
+/* whole session: deposit, new game, action and both signidice parts */
+void session_round(benchmark::State& state) {
+    game_sim::simulator sim(game_name, {}, 0u);
+    const auto bet = eosio::asset(1'0000, game_sdk::game::core_symbol);
+    const game_sim::player_t player = [](const auto&, auto&) { return game_sim::player_action{0, {}}; };
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sim.play_round(bet, player));
+    }
+}
+BENCHMARK(session_round);
+
+} // namespace
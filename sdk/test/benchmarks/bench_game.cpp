@@ -0,0 +1,29 @@
+#include <game-contract-sdk/game_base.hpp>
+
+/*
+ Minimal game for dispatch benchmarks: single action, single random, finishes with returned deposit.
+*/
+
+namespace bench {
+
+class [[eosio::contract]] bench_game : public game_sdk::game {
+  public:
+    bench_game(eosio::name receiver, eosio::name code, eosio::datastream<const char*> ds) : game(receiver, code, ds) {}
+
+    virtual void on_new_game(uint64_t ses_id) final { require_action(0); }
+
+    virtual void on_action(uint64_t ses_id, uint16_t type, std::vector<game_sdk::param_t> params) final {
+        update_max_win(get_session(ses_id).deposit);
+        require_random();
+    }
+
+    virtual void on_random(uint64_t ses_id, eosio::checksum256 rand) final {
+        finish_game(get_session(ses_id).deposit);
+    }
+
+    virtual void on_finish(uint64_t ses_id) final {}
+};
+
+} // namespace bench
+
+GAME_CONTRACT(bench::bench_game)
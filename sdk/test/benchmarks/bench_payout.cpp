@@ -0,0 +1,49 @@
+#include <game-contract-sdk/payout_math.hpp>
+
+#include <eosio/asset.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+const eosio::symbol bet_symbol("BET", 4);
+
+/* former settlement of player's win with checked asset operations */
+void settle_win_asset_ops(benchmark::State& state) {
+    const eosio::asset deposit(100000, bet_symbol);
+    const eosio::asset bonus_deposit(30000, bet_symbol);
+    eosio::asset player_win(250000, bet_symbol);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(player_win);
+        const auto bonus_win = player_win * bonus_deposit.amount / deposit.amount;
+        const auto real_win = player_win - bonus_win;
+        const auto real_deposit = deposit - bonus_deposit;
+        benchmark::DoNotOptimize(real_win);
+        benchmark::DoNotOptimize(bonus_deposit + bonus_win);
+        benchmark::DoNotOptimize(real_deposit + real_win);
+    }
+}
+BENCHMARK(settle_win_asset_ops);
+
+void settle_win(benchmark::State& state) {
+    int64_t player_win = 250000;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(player_win);
+        benchmark::DoNotOptimize(service::payout_math::settle_win(100000, 30000, player_win));
+    }
+}
+BENCHMARK(settle_win);
+
+void settle_loss(benchmark::State& state) {
+    int64_t player_payout = 50000;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(player_payout);
+        benchmark::DoNotOptimize(service::payout_math::settle_loss(100000, 30000, player_payout));
+    }
+}
+BENCHMARK(settle_loss);
+
+} // namespace
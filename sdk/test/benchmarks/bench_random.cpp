@@ -0,0 +1,83 @@
+#include <game-contract-sdk/service.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <numeric>
+
+namespace {
+
+eosio::checksum256 seed_digest(uint64_t seed) {
+    return eosio::checksum256(std::array<uint64_t, 4>{seed, seed * 3 + 1, seed * 7 + 2, seed * 13 + 3});
+}
+
+void prng_next(benchmark::State& state) {
+    const auto range = static_cast<uint64_t>(state.range(0));
+    service::ShaMixWithRejection prng(seed_digest(1));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(prng.next(0, range));
+    }
+}
+// typical game ranges up to the widest one, range affects 256-bit division cost
+BENCHMARK(prng_next)->Arg(2)->Arg(6)->Arg(37)->Arg(100)->Arg(int64_t(1) << 32)->Arg(INT64_MAX);
+
+void prng_shuffle(benchmark::State& state) {
+    std::vector<int> deck(state.range(0));
+    std::iota(deck.begin(), deck.end(), 0);
+    service::PRNG::Ptr prng = std::make_shared<service::ShaMixWithRejection>(seed_digest(2));
+
+    for (auto _ : state) {
+        service::shuffle(deck.begin(), deck.end(), prng);
+        benchmark::DoNotOptimize(deck.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(prng_shuffle)->Arg(36)->Arg(52)->Arg(416); // short and full deck, 8 decks shoe
+
+template <typename T> void cut_to(benchmark::State& state) {
+    auto digest = seed_digest(3);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(digest);
+        benchmark::DoNotOptimize(service::cut_to<T>(digest));
+    }
+}
+BENCHMARK_TEMPLATE(cut_to, uint32_t);
+BENCHMARK_TEMPLATE(cut_to, uint64_t);
+BENCHMARK_TEMPLATE(cut_to, uint128_t);
+
+void uniform(benchmark::State& state) {
+    auto digest = seed_digest(5);
+    const auto n = static_cast<uint64_t>(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(digest);
+        benchmark::DoNotOptimize(service::uniform(digest, n));
+    }
+}
+BENCHMARK(uniform)->Arg(100)->Arg(3u << 30);
+
+template <uint64_t N> void uniform_const(benchmark::State& state) {
+    auto digest = seed_digest(5);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(digest);
+        benchmark::DoNotOptimize(service::uniform<N>(digest));
+    }
+}
+BENCHMARK_TEMPLATE(uniform_const, 100);
+BENCHMARK_TEMPLATE(uniform_const, 64);
+
+void signidice(benchmark::State& state) {
+    const auto digest = seed_digest(4);
+    const std::string sign(344, 'A');   // base64 of 2048-bit signature
+    const std::string rsa_key(392, 'B'); // base64 of 2048-bit public key
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(service::signidice(digest, sign, rsa_key));
+    }
+}
+// native rsa verification is stubbed, so it measures digest hashing only
+BENCHMARK(signidice);
+
+} // namespace
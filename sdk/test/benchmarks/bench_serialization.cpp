@@ -0,0 +1,57 @@
+#include <game-contract-sdk/game_base.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using game_sdk::game;
+using events = game::events;
+
+const eosio::asset deposit(10'0000, game::core_symbol);
+
+game::session_row make_session() {
+    game::session_row session{};
+    session.ses_id = 42;
+    session.casino_id = 1;
+    session.ses_seq = 100;
+    session.player = "player"_n;
+    session.state = static_cast<uint8_t>(game::state::req_action);
+    session.params_id = 1;
+    session.token = "BET";
+    session.deposit = deposit;
+    session.bonus_deposit = eosio::asset(0, game::core_symbol);
+    session.last_max_win = deposit * 2;
+    return session;
+}
+
+template <typename Event> void event_packing(benchmark::State& state, const Event& event) {
+    for (auto _ : state) {
+        // the same as `game::emit_event`: event data is packed into `send` action args
+        const auto data = eosio::pack(event);
+        benchmark::DoNotOptimize(
+            eosio::pack(std::make_tuple("game"_n, uint64_t(1), uint64_t(2), uint64_t(42), Event::type, data)));
+    }
+}
+BENCHMARK_CAPTURE(event_packing, action_request, events::action_request{0, true});
+BENCHMARK_CAPTURE(event_packing, signidice_part_1_request, events::signidice_part_1_request{});
+BENCHMARK_CAPTURE(event_packing, game_finished, events::game_finished{deposit, game_sdk::bytes(64, 'x')});
+
+void session_pack(benchmark::State& state) {
+    const auto session = make_session();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(eosio::pack(session));
+    }
+}
+BENCHMARK(session_pack);
+
+void session_unpack(benchmark::State& state) {
+    const auto data = eosio::pack(make_session());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(eosio::unpack<game::session_row>(data));
+    }
+}
+BENCHMARK(session_unpack);
+
+} // namespace
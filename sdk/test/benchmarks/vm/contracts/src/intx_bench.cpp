@@ -0,0 +1,83 @@
+#include <eosio/eosio.hpp>
+
+#include <game-contract-sdk/service.hpp>
+
+/*
+ Benchmark contract of intx arithmetic in WASM.
+ Every action runs one operation `iterations` times on pseudo random operands,
+ `noop` op generates operands only, its cost is subtracted by test.
+*/
+
+namespace intx_bench {
+
+/* xorshift64*, cheap operands generator */
+class operands {
+  public:
+    explicit operands(uint64_t seed) : _state(seed | 1u) {}
+
+    uint64_t next() {
+        _state ^= _state >> 12;
+        _state ^= _state << 25;
+        _state ^= _state >> 27;
+        return _state * 0x2545f4914f6cdd1dull;
+    }
+
+    intx::uint128 next128() { return {next(), next()}; }
+
+    intx::uint256 next256() { return {next128(), next128()}; }
+
+  private:
+    uint64_t _state;
+};
+
+class [[eosio::contract("intx_bench")]] intx_bench : public eosio::contract {
+  public:
+    using eosio::contract::contract;
+
+    [[eosio::action("run")]] void run(const std::string& op, uint32_t iterations, uint64_t seed) {
+        operands gen(seed);
+        uint64_t sink = 0;
+
+        const auto loop = [&](auto&& body) {
+            for (uint32_t i = 0; i != iterations; ++i) {
+                sink ^= body();
+            }
+        };
+
+        if (op == "noop") {
+            loop([&] { return gen.next() ^ gen.next(); });
+        } else if (op == "umul") {
+            loop([&] { return intx::umul(gen.next(), gen.next()).hi; });
+        } else if (op == "reciprocal") {
+            loop([&] { return intx::reciprocal_2by1(gen.next() | (uint64_t(1) << 63)); });
+        } else if (op == "div2by1") {
+            const auto d = gen.next() | (uint64_t(1) << 63);
+            const auto v = intx::reciprocal_2by1(d);
+            loop([&] { return intx::udivrem_2by1({gen.next() % d, gen.next()}, d, v).quot; });
+        } else if (op == "divlong") {
+            const auto d = gen.next() | (uint64_t(1) << 63);
+            loop([&] { return intx::udivrem_norm_2by1({gen.next() % d, gen.next()}, d).quot; });
+        } else if (op == "div128") {
+            loop([&] { return (gen.next128() / intx::uint128(gen.next())).lo; });
+        } else if (op == "mul256") {
+            loop([&] { return uint64_t(gen.next256() * gen.next256()); });
+        } else if (op == "div256") {
+            loop([&] { return uint64_t(gen.next256() / (intx::uint256(gen.next128()) + 1)); });
+        } else if (op == "mod256by64") {
+            loop([&] { return uint64_t(gen.next256() % intx::uint256(gen.next() | 1u)); });
+        } else if (op == "mod256by64d") {
+            const intx::divisor64 d(gen.next() | 1u);
+            loop([&] { return gen.next256() % d; });
+        } else if (op == "prngnext") {
+            service::ShaMixWithRejection prng(eosio::sha256(reinterpret_cast<const char*>(&seed), sizeof(seed)));
+            loop([&] { return prng.next(0, 100); });
+        } else {
+            eosio::check(false, "unknown op");
+        }
+
+        // result is printed, so computations aren't optimized out
+        eosio::print(sink);
+    }
+};
+
+} // namespace intx_bench
@@ -0,0 +1,108 @@
+#include <game_tester/game_tester.hpp>
+
+#include <cstdlib>
+#include <fstream>
+
+#include "contracts.hpp"
+
+namespace testing {
+
+/*
+ In-VM costs of intx operations: every op is run `iterations` times in single action,
+ cost of operands generation (`noop`) is subtracted.
+ Elapsed time of action is used besides billed CPU, billed CPU has lower bound per transaction.
+ Iterations count is taken from `INTX_BENCH_ITERATIONS`, report is written to `INTX_BENCH_REPORT` CSV if set.
+*/
+class intx_bench_tester : public game_tester {
+  public:
+    static const name bench_name;
+    static constexpr uint32_t repetitions = 5u;
+
+    struct op_cost {
+        double elapsed_ns{0.}; // per iteration
+        double cpu_ns{0.};     // per iteration
+    };
+
+  public:
+    intx_bench_tester() {
+        create_account(bench_name);
+        deploy_contract<intx_bench_contract>(bench_name);
+    }
+
+    static uint32_t iterations() {
+        const auto* env = std::getenv("INTX_BENCH_ITERATIONS");
+        return env ? std::stoul(env) : 1000u;
+    }
+
+    /* p50 of costs of `repetitions` actions */
+    resource_sample measure(const std::string& op, uint32_t count) {
+        resource_profiler profiler;
+        auto* previous_profiler = get_profiler();
+        set_profiler(&profiler);
+        for (uint32_t seed = 1; seed <= repetitions; ++seed) {
+            BOOST_REQUIRE_EQUAL(
+                push_action(bench_name, N(run), bench_name, mvo()("op", op)("iterations", count)("seed", seed)),
+                success());
+        }
+        set_profiler(previous_profiler);
+
+        const auto& samples = profiler.samples(bench_name, "run");
+        BOOST_REQUIRE_EQUAL(samples.size(), repetitions);
+
+        resource_sample result;
+        result.elapsed_us = resource_profiler::percentile(samples, &resource_sample::elapsed_us, 50.);
+        result.cpu_us = resource_profiler::percentile(samples, &resource_sample::cpu_us, 50.);
+        return result;
+    }
+
+    op_cost cost(const std::string& op, const resource_sample& baseline) {
+        const auto count = iterations();
+        const auto sample = measure(op, count);
+        return op_cost{
+            1000. * (sample.elapsed_us - baseline.elapsed_us) / count,
+            1000. * (sample.cpu_us - baseline.cpu_us) / count,
+        };
+    }
+};
+
+const name intx_bench_tester::bench_name = N(intxbench);
+
+BOOST_AUTO_TEST_SUITE(intx_bench_tests)
+
+BOOST_FIXTURE_TEST_CASE(intx_ops_cost_test, intx_bench_tester) try {
+    const auto baseline = measure("noop", iterations());
+
+    std::ofstream report;
+    if (const auto* path = std::getenv("INTX_BENCH_REPORT")) {
+        report.open(path);
+        report << "op,iterations,elapsed_ns,cpu_ns\n";
+    }
+
+    for (const auto* op : {"umul",
+                           "reciprocal",
+                           "div2by1",
+                           "divlong",
+                           "div128",
+                           "mul256",
+                           "div256",
+                           "mod256by64",
+                           "mod256by64d",
+                           "prngnext"}) {
+        const auto result = cost(op, baseline);
+        BOOST_TEST_MESSAGE(op << ": " << result.elapsed_ns << "ns elapsed, " << result.cpu_ns << "ns cpu per op");
+        if (report.is_open()) {
+            report << op << ',' << iterations() << ',' << result.elapsed_ns << ',' << result.cpu_ns << '\n';
+        }
+    }
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_FIXTURE_TEST_CASE(intx_unknown_op_test, intx_bench_tester) try {
+    BOOST_REQUIRE_EQUAL(push_action(bench_name, N(run), bench_name, mvo()("op", "nope")("iterations", 1)("seed", 1)),
+                        wasm_assert_msg("unknown op"));
+}
+FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace testing
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <game_simulator/simulator.hpp>
+
+#include <string>
+#include <unordered_map>
+
+/*
+ Exhaustive exploration of game's state space on native simulator.
+ Every player's decision and every random outcome bucket is played out,
+ expected values are combined bottom-up, so resulting RTP is exact instead of Monte Carlo estimate.
+*/
+
+namespace game_sim {
+
+/* digest representing all signidice results game maps to the same outcome */
+struct random_bucket {
+    checksum256 digest;
+    long double probability;
+};
+
+/* player's candidate answers to action request, the most profitable one is taken */
+using decisions_t = std::function<std::vector<player_action>(const events::action_request&)>;
+
+/* outcome buckets of signidice, probabilities should sum to 1 */
+using random_model_t = std::function<std::vector<random_bucket>()>;
+
+/* digest for which `service::cut_to<T>()` returns `value` */
+inline checksum256 cut_to_digest(uint64_t value) {
+    return checksum256(std::array<unsigned __int128, 2>{0u, value});
+}
+
+/* digest for which `service::uniform(digest, n)` returns `value`, its first word is never rejected */
+inline checksum256 uniform_digest(uint64_t value, uint64_t n) {
+    check(value < n, "value is out of range");
+    // the largest word mapped to `value`, low part of its product is at least 2^64 - n
+    const auto word = uint64_t((((unsigned __int128)(value + 1) << 64) - 1) / n);
+    return checksum256(std::array<uint64_t, 4>{word, 0u, 0u, 0u});
+}
+
+/* `count` equiprobable buckets, bucket `i` gives `service::cut_to<T>() == i`, e.g. for `cut_to<T>() % count` */
+inline std::vector<random_bucket> cut_to_buckets(uint64_t count) {
+    std::vector<random_bucket> buckets;
+    buckets.reserve(count);
+    for (uint64_t value = 0; value != count; ++value) {
+        buckets.push_back(random_bucket{cut_to_digest(value), 1.L / count});
+    }
+    return buckets;
+}
+
+/* `n` equiprobable buckets, bucket `i` gives `service::uniform(digest, n) == i` */
+inline std::vector<random_bucket> uniform_buckets(uint64_t n) {
+    std::vector<random_bucket> buckets;
+    buckets.reserve(n);
+    for (uint64_t value = 0; value != n; ++value) {
+        buckets.push_back(random_bucket{uniform_digest(value, n), 1.L / n});
+    }
+    return buckets;
+}
+
+struct exploration_result {
+    long double expected_bet{0.};    // including deposits made with actions
+    long double expected_payout{0.}; // including returned deposit
+    uint64_t states{0u};             // distinct states evaluated
+    uint64_t memo_hits{0u};
+
+    double rtp() const { return expected_bet > 0. ? double(expected_payout / expected_bet) : 0.; }
+};
+
+struct explore_config {
+    uint32_t workers{std::max(std::thread::hardware_concurrency(), 1u)};
+    uint32_t depth_limit{256u}; // max steps of session, guards against looping games
+};
+
+namespace detail {
+
+/* expected amounts from some state to the end of session */
+struct expectation {
+    long double bet{0.};
+    long double payout{0.};
+
+    long double profit() const { return payout - bet; }
+
+    expectation& operator+=(const expectation& other) {
+        bet += other.bet;
+        payout += other.payout;
+        return *this;
+    }
+
+    expectation operator*(long double probability) const { return {bet * probability, payout * probability}; }
+};
+
+/* next step of session: player's action or signidice part */
+struct move {
+    uint32_t request;
+    player_action action;
+    random_bucket bucket;
+};
+
+/* moves available in state, `choice` is true when player picks one, otherwise all are weighted by probability */
+struct branching {
+    bool choice{false};
+    std::vector<move> moves;
+};
+
+inline branching branches(const simulator::event_t& event, const decisions_t& decisions, const random_model_t& random) {
+    branching result;
+    switch (event.first) {
+    case events::action_request::type:
+        result.choice = true;
+        for (auto& action : decisions(eosio::unpack<events::action_request>(event.second))) {
+            result.moves.push_back(move{event.first, std::move(action), {}});
+        }
+        break;
+    case events::signidice_part_1_request::type:
+        result.moves.push_back(move{event.first, {}, {}});
+        break;
+    case events::signidice_part_2_request::type:
+        for (auto& bucket : random()) {
+            result.moves.push_back(move{event.first, {}, std::move(bucket)});
+        }
+        break;
+    case events::game_finished::type:
+    case events::game_failed::type:
+        break;
+    default:
+        throw std::logic_error("unexpected event type: " + std::to_string(event.first));
+    }
+    return result;
+}
+
+/* zeroes session's digest and last update time: both don't affect further game flow */
+inline void mask_session_row(std::vector<char>& data) {
+    size_t pos = 4 * sizeof(uint64_t) + sizeof(uint8_t); // ses_id, casino_id, ses_seq, player, state
+    const auto skip_vector = [&](size_t item_size) {
+        uint32_t count = 0u;
+        uint8_t byte = 0u, shift = 0u;
+        do {
+            check(pos < data.size(), "malformed session row");
+            byte = static_cast<uint8_t>(data[pos++]);
+            count |= uint32_t(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        pos += count * item_size;
+    };
+
+    pos += sizeof(uint64_t);   // params_id
+    skip_vector(sizeof(char)); // token
+    pos += 2 * sizeof(asset);                         // deposit, bonus_deposit
+
+    const auto masked_size = sizeof(checksum256) + sizeof(uint64_t); // digest, last_update
+    check(pos + masked_size <= data.size(), "malformed session row");
+    std::fill_n(data.begin() + pos, masked_size, 0);
+}
+
+template <typename T> void append(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+class worker {
+  public:
+    worker(simulator& sim, const decisions_t& decisions, const random_model_t& random, uint32_t depth_limit)
+        : _sim(sim), _decisions(decisions), _random(random), _depth_limit(depth_limit) {}
+
+    /* applies move, returns amounts deposited and paid out by it */
+    expectation apply(uint64_t ses_id, const move& step) {
+        const auto bet = _sim.deposited().amount;
+        const auto payout = _sim.payout().amount;
+
+        switch (step.request) {
+        case events::action_request::type:
+            _sim.player_move(ses_id, step.action);
+            break;
+        case events::signidice_part_1_request::type:
+            _sim.signidice_part_1(ses_id);
+            break;
+        default:
+            _sim.signidice_part_2(ses_id, step.bucket.digest);
+        }
+
+        return expectation{
+            static_cast<long double>(_sim.deposited().amount - bet),
+            static_cast<long double>(_sim.payout().amount - payout),
+        };
+    }
+
+    /* expected amounts from current state to the end of session */
+    expectation evaluate(uint64_t ses_id, uint32_t depth = 0u) {
+        const auto* event = _sim.pending_event(ses_id);
+        if (event == nullptr) {
+            throw std::logic_error("game didn't request next step for session " + std::to_string(ses_id));
+        }
+        if (depth > _depth_limit) {
+            throw std::runtime_error("session depth limit exceeded");
+        }
+
+        auto key = state_key(*event);
+        if (const auto it = _memo.find(key); it != _memo.end()) {
+            _memo_hits++;
+            return it->second;
+        }
+
+        const auto branch = branches(*event, _decisions, _random);
+        const auto result = evaluate(ses_id, branch, depth);
+        _memo.emplace(std::move(key), result);
+        return result;
+    }
+
+    /* combines outcomes of all moves of branching point */
+    expectation evaluate(uint64_t ses_id, const branching& branch, uint32_t depth) {
+        if (branch.moves.empty()) {
+            return {};
+        }
+        if (branch.moves.size() == 1u && !branch.choice) {
+            auto result = apply(ses_id, branch.moves.front());
+            return result += evaluate(ses_id, depth + 1u);
+        }
+
+        const auto origin = _sim.save();
+        std::optional<expectation> result;
+        for (const auto& step : branch.moves) {
+            auto outcome = evaluate_move(ses_id, step, depth);
+            _sim.restore(origin);
+
+            if (!branch.choice) {
+                result = result.value_or(expectation{}) += *outcome * step.bucket.probability;
+            } else if (outcome && (!result || outcome->profit() > result->profit())) {
+                result = outcome;
+            }
+        }
+
+        if (!result) {
+            throw std::logic_error("no valid player's decision for session " + std::to_string(ses_id));
+        }
+        return *result;
+    }
+
+    /* outcome of single move, empty if game rejects player's decision */
+    std::optional<expectation> evaluate_move(uint64_t ses_id, const move& step, uint32_t depth) {
+        expectation result;
+        try {
+            result = apply(ses_id, step);
+        } catch (const assert_error&) {
+            if (step.request != events::action_request::type) {
+                throw;
+            }
+            return std::nullopt;
+        }
+        return result += evaluate(ses_id, depth + 1u);
+    }
+
+    uint64_t states() const { return _memo.size(); }
+
+    uint64_t memo_hits() const { return _memo_hits; }
+
+  private:
+    /* whole contract database and pending request, session digest and time are masked */
+    std::string state_key(const simulator::event_t& event) const {
+        std::string key;
+        append(key, event.first);
+        if (event.first == events::action_request::type) {
+            key.append(event.second.begin(), event.second.end());
+        }
+
+        // secondary indices are derived from rows, so primary index describes state completely
+        for (const auto& [table, tab] : _sim.chain().db().primary.tables()) {
+            append(key, std::get<0>(table));
+            append(key, std::get<1>(table));
+            append(key, std::get<2>(table));
+            const auto is_session = std::get<0>(table) == _sim.game().value && std::get<2>(table) == "session"_n.value;
+            for (const auto& row : tab.rows) {
+                append(key, row.primary);
+                append(key, row.data.size());
+                if (is_session) {
+                    auto data = row.data;
+                    mask_session_row(data);
+                    key.append(data.begin(), data.end());
+                } else {
+                    key.append(row.data.begin(), row.data.end());
+                }
+            }
+        }
+        return key;
+    }
+
+  private:
+    simulator& _sim;
+    const decisions_t& _decisions;
+    const random_model_t& _random;
+    const uint32_t _depth_limit;
+
+    std::unordered_map<std::string, expectation> _memo;
+    uint64_t _memo_hits{0u};
+};
+
+} // namespace detail
+
+/**
+   Explores all sessions started with `bet` deposit.
+   Session is played on single simulator up to the first branching point,
+   its moves are evaluated on `config.workers` threads, every thread has own simulator and memo.
+   Simulator time doesn't advance during exploration, so sessions never expire.
+*/
+inline exploration_result explore(const simulator_factory_t& factory,
+                                  const asset& bet,
+                                  const decisions_t& decisions,
+                                  const random_model_t& random,
+                                  const explore_config& config = explore_config{}) {
+    using detail::expectation;
+
+    exploration_result result;
+
+    auto root_sim = factory(0u);
+    root_sim->chain().set_time_step(0u);
+    detail::worker root(*root_sim, decisions, random, config.depth_limit);
+
+    const auto ses_id = root_sim->new_session(bet);
+    expectation prefix{static_cast<long double>(bet.amount), 0.};
+
+    // play out moves without alternatives
+    auto branch = detail::branching{};
+    for (uint32_t depth = 0;; ++depth) {
+        const auto* event = root_sim->pending_event(ses_id);
+        if (event == nullptr) {
+            throw std::logic_error("game didn't request next step for session " + std::to_string(ses_id));
+        }
+        if (depth > config.depth_limit) {
+            throw std::runtime_error("session depth limit exceeded");
+        }
+        branch = detail::branches(*event, decisions, random);
+        if (branch.moves.size() != 1u) {
+            break;
+        }
+        prefix += root.apply(ses_id, branch.moves.front());
+    }
+
+    const auto origin = root_sim->save();
+    const auto root_states = root.states();
+    root_sim.reset();
+
+    std::vector<std::optional<expectation>> outcomes(branch.moves.size());
+    std::vector<uint64_t> states(config.workers), memo_hits(config.workers);
+    std::vector<std::exception_ptr> errors(config.workers);
+    std::atomic<size_t> next_move{0u};
+    std::vector<std::thread> threads;
+
+    for (uint32_t worker = 0; worker != config.workers; ++worker) {
+        threads.emplace_back([&, worker]() {
+            try {
+                auto sim = factory(worker);
+                sim->chain().set_time_step(0u);
+                detail::worker explorer(*sim, decisions, random, config.depth_limit);
+
+                for (auto i = next_move++; i < branch.moves.size(); i = next_move++) {
+                    sim->restore(origin);
+                    outcomes[i] = explorer.evaluate_move(ses_id, branch.moves[i], 0u);
+                }
+
+                states[worker] = explorer.states();
+                memo_hits[worker] = explorer.memo_hits();
+            } catch (...) {
+                errors[worker] = std::current_exception();
+                next_move = branch.moves.size(); // stop other workers
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::optional<expectation> combined;
+    for (size_t i = 0; i != outcomes.size(); ++i) {
+        if (!branch.choice) {
+            combined = combined.value_or(expectation{}) += *outcomes[i] * branch.moves[i].bucket.probability;
+        } else if (outcomes[i] && (!combined || outcomes[i]->profit() > combined->profit())) {
+            combined = outcomes[i];
+        }
+    }
+    if (!combined && branch.choice) {
+        throw std::logic_error("no valid player's decision for session " + std::to_string(ses_id));
+    }
+    prefix += combined.value_or(expectation{});
+
+    result.expected_bet = prefix.bet;
+    result.expected_payout = prefix.payout;
+    for (uint32_t worker = 0; worker != config.workers; ++worker) {
+        result.states += states[worker];
+        result.memo_hits += memo_hits[worker];
+    }
+    result.states += root_states;
+    return result;
+}
+
+} // namespace game_sim
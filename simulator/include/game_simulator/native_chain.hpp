@@ -0,0 +1,205 @@
+#pragma once
+
+#include <game_simulator/native_db.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ In-memory chain for native (host compiled) game contracts.
+ Keeps contract database, action context and inline actions sent by contract.
+ Contract reaches it through eosio intrinsics defined in `src/intrinsics.cpp`,
+ every host thread has its own chain, see `native_chain::current()`.
+ NOTE: header must not include eosio.cdt headers, intrinsics are declared there with wasm types.
+*/
+
+namespace game_sim {
+
+/* thrown by `eosio_exit`, finishes action */
+struct exit_signal {
+    int32_t code;
+};
+
+/* inline action captured from `send_inline`, authorizations are dropped */
+struct inline_action {
+    uint64_t account;
+    uint64_t name;
+    std::vector<char> data;
+};
+
+class native_chain {
+  public:
+    using apply_t = void (*)(uint64_t receiver, uint64_t code, uint64_t action);
+
+    static constexpr uint64_t default_time_step_us = 500000u;
+
+  public:
+    /* chain bound to current thread */
+    static native_chain*& current() {
+        thread_local native_chain* chain = nullptr;
+        return chain;
+    }
+
+    static native_chain& get() {
+        auto* chain = current();
+        if (chain == nullptr) {
+            throw std::logic_error("native chain isn't bound to this thread");
+        }
+        return *chain;
+    }
+
+    /**
+       Executes single action on `receiver` contract.
+       On assert all table changes and inline actions of this action are reverted and `assert_error` is rethrown.
+       Returns inline actions sent by contract.
+    */
+    std::vector<inline_action>
+    push_action(apply_t apply, uint64_t receiver, uint64_t code, uint64_t action, std::vector<char> data) {
+        _receiver = receiver;
+        _action_data = std::move(data);
+        _inline_actions.clear();
+        _db.clear_iterators();
+        _db.start_undo();
+        _now_us += _time_step_us;
+
+        try {
+            apply(receiver, code, action);
+        } catch (const exit_signal& exit) {
+            if (exit.code != 0) {
+                rollback();
+                throw assert_error("action exited with code " + std::to_string(exit.code));
+            }
+        } catch (...) {
+            rollback();
+            throw;
+        }
+
+        _db.commit_undo();
+        return std::move(_inline_actions);
+    }
+
+    /* runs host code in context of `receiver` contract without action, e.g. to fill tables of other contracts */
+    template <typename Func> void as_contract(uint64_t receiver, Func&& func) {
+        const auto prev = _receiver;
+        _receiver = receiver;
+        _db.clear_iterators();
+        try {
+            func();
+        } catch (...) {
+            _receiver = prev;
+            _db.clear_iterators();
+            throw;
+        }
+        _receiver = prev;
+        _db.clear_iterators();
+    }
+
+    // =============================================================
+    // Context
+    // =============================================================
+    uint64_t receiver() const { return _receiver; }
+
+    const std::vector<char>& action_data() const { return _action_data; }
+
+    uint64_t now() const { return _now_us; }
+
+    void set_now(uint64_t now_us) { _now_us = now_us; }
+
+    void set_time_step(uint64_t step_us) { _time_step_us = step_us; }
+
+    void send_inline(const char* data, size_t size);
+
+    void print(const char* str, size_t size) {
+        if (_print_enabled) {
+            _console.append(str, size);
+        }
+    }
+
+    void set_print_enabled(bool enabled) { _print_enabled = enabled; }
+
+    std::string take_console() { return std::move(_console); }
+
+    native_db& db() { return _db; }
+
+    const native_db& db() const { return _db; }
+
+    ram_ledger& ram() { return _db.ram; }
+
+    // =============================================================
+    // Programmed hashes
+    // =============================================================
+    /* makes `sha256` intrinsic return `digest` for `preimage`, used to inject signidice results */
+    void program_sha256(std::string preimage, const std::array<uint8_t, 32>& digest) {
+        _programmed_sha256[std::move(preimage)] = digest;
+    }
+
+    void clear_programmed_sha256() { _programmed_sha256.clear(); }
+
+    const std::array<uint8_t, 32>* programmed_sha256(const char* data, size_t size) const {
+        if (_programmed_sha256.empty()) {
+            return nullptr;
+        }
+        const auto it = _programmed_sha256.find(std::string(data, size));
+        return it != _programmed_sha256.end() ? &it->second : nullptr;
+    }
+
+  private:
+    void rollback() {
+        _db.undo();
+        _inline_actions.clear();
+    }
+
+  private:
+    native_db _db;
+
+    uint64_t _receiver{0u};
+    std::vector<char> _action_data;
+    std::vector<inline_action> _inline_actions;
+
+    uint64_t _now_us{0u};
+    uint64_t _time_step_us{default_time_step_us};
+
+    bool _print_enabled{false};
+    std::string _console;
+
+    std::map<std::string, std::array<uint8_t, 32>> _programmed_sha256; // preimage -> digest
+};
+
+/* unpacks `eosio::action` serialized by contract */
+inline void native_chain::send_inline(const char* data, size_t size) {
+    size_t pos = 0u;
+    const auto read = [&](void* out, size_t len) {
+        check(pos + len <= size, "malformed inline action");
+        std::memcpy(out, data + pos, len);
+        pos += len;
+    };
+    const auto read_varuint32 = [&]() {
+        uint32_t value = 0u;
+        uint8_t byte = 0u, shift = 0u;
+        do {
+            read(&byte, 1u);
+            value |= uint32_t(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return value;
+    };
+
+    inline_action action;
+    read(&action.account, sizeof(action.account));
+    read(&action.name, sizeof(action.name));
+
+    const auto auth_count = read_varuint32();
+    pos += auth_count * 2u * sizeof(uint64_t); // skip permission levels
+
+    action.data.resize(read_varuint32());
+    read(action.data.data(), action.data.size());
+
+    _inline_actions.push_back(std::move(action));
+}
+
+} // namespace game_sim
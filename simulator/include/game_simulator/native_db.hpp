@@ -0,0 +1,678 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/*
+ Contract database of native chain.
+ Rows of every table are kept in flat vectors sorted by key, tables are looked up by (code, scope, table).
+ Semantic follows chain's `db_*_i64` and `db_idx*` intrinsics: iterators stay valid
+ while row exists, end iterators are negative, empty table is treated as absent.
+ Changes made during undo session are logged per row, so failed action is reverted without copy of database.
+*/
+
+namespace game_sim {
+
+/* thrown by `eosio_assert` family, action is reverted */
+struct assert_error : public std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+inline void check(bool condition, const char* msg) {
+    if (!condition) {
+        throw assert_error(msg);
+    }
+}
+
+using table_key = std::tuple<uint64_t, uint64_t, uint64_t>; // code, scope, table
+using key256 = std::array<unsigned __int128, 2>;
+
+/* RAM billing of chain, see `eosio::chain::config::billable_size` */
+namespace billing {
+constexpr int64_t overhead_per_row_per_index = 32;
+constexpr int64_t table = 44 + 2 * overhead_per_row_per_index;
+constexpr int64_t primary_row = 44 + 2 * overhead_per_row_per_index; // + data size
+
+template <typename Secondary>
+constexpr int64_t secondary_row = 24 + int64_t(sizeof(Secondary)) + 3 * overhead_per_row_per_index;
+
+static_assert(secondary_row<uint64_t> == 128 && secondary_row<unsigned __int128> == 136 &&
+                  secondary_row<key256> == 152 && secondary_row<double> == 128,
+              "secondary index billing doesn't match chain");
+} // namespace billing
+
+/* per account RAM usage, disabled by default */
+class ram_ledger {
+  public:
+    void bill(uint64_t payer, int64_t delta) {
+        if (_enabled && delta != 0) {
+            _usage[payer] += delta;
+            if (_recording) {
+                _undo.emplace_back(payer, delta);
+            }
+        }
+    }
+
+    int64_t usage(uint64_t account) const {
+        const auto it = _usage.find(account);
+        return it == _usage.end() ? 0 : it->second;
+    }
+
+    const std::map<uint64_t, int64_t>& all() const { return _usage; }
+
+    void set_enabled(bool enabled) { _enabled = enabled; }
+
+    bool enabled() const { return _enabled; }
+
+    void start_undo() {
+        _undo.clear();
+        _recording = true;
+    }
+
+    void commit_undo() {
+        _undo.clear();
+        _recording = false;
+    }
+
+    void undo() {
+        for (auto it = _undo.rbegin(); it != _undo.rend(); ++it) {
+            _usage[it->first] -= it->second;
+        }
+        commit_undo();
+    }
+
+  private:
+    bool _enabled{false};
+    std::map<uint64_t, int64_t> _usage;
+
+    bool _recording{false};
+    std::vector<std::pair<uint64_t, int64_t>> _undo; // payer, delta
+};
+
+/* iterator handles of one index type, valid during single action */
+template <typename TableRef, typename Key> class iterator_cache {
+  public:
+    int32_t add(TableRef table, const Key& key) {
+        _iterators.emplace_back(table, key);
+        return static_cast<int32_t>(_iterators.size() - 1);
+    }
+
+    int32_t end_of(TableRef table) {
+        const auto it = std::find(_ends.begin(), _ends.end(), table);
+        if (it != _ends.end()) {
+            return -static_cast<int32_t>(it - _ends.begin()) - 2;
+        }
+        _ends.push_back(table);
+        return -static_cast<int32_t>(_ends.size()) - 1;
+    }
+
+    const std::pair<TableRef, Key>& at(int32_t itr) const {
+        check(itr >= 0 && static_cast<size_t>(itr) < _iterators.size(), "invalid iterator");
+        return _iterators[static_cast<size_t>(itr)];
+    }
+
+    TableRef table_of_end(int32_t itr) const {
+        check(itr < -1 && static_cast<size_t>(-itr - 2) < _ends.size(), "invalid end iterator");
+        return _ends[static_cast<size_t>(-itr - 2)];
+    }
+
+    void clear() {
+        _iterators.clear();
+        _ends.clear();
+    }
+
+  private:
+    std::vector<std::pair<TableRef, Key>> _iterators;
+    std::vector<TableRef> _ends;
+};
+
+// =============================================================
+// Primary index
+// =============================================================
+class primary_index {
+  public:
+    struct row {
+        uint64_t primary;
+        uint64_t payer;
+        std::vector<char> data;
+    };
+
+    struct table {
+        uint64_t payer{0u};
+        std::vector<row> rows; // sorted by primary
+    };
+
+    using tables_t = std::map<table_key, table>;
+
+  public:
+    int32_t store(ram_ledger& ram,
+                  uint64_t receiver,
+                  uint64_t scope,
+                  uint64_t table_name,
+                  uint64_t payer,
+                  uint64_t id,
+                  const void* data,
+                  size_t len) {
+        check(payer != 0u, "must specify a valid account to pay for new record");
+
+        auto tab = _tables.try_emplace(table_key{receiver, scope, table_name}).first;
+        auto& rows = tab->second.rows;
+        const auto pos = lower(rows, id);
+        check(pos == rows.end() || pos->primary != id, "key already exists");
+
+        remember(tab, id);
+        if (rows.empty()) {
+            tab->second.payer = payer;
+            ram.bill(payer, billing::table);
+        }
+
+        const auto* bytes = static_cast<const char*>(data);
+        rows.insert(pos, row{id, payer, std::vector<char>(bytes, bytes + len)});
+        ram.bill(payer, billing::primary_row + int64_t(len));
+
+        return _iterators.add(tab, id);
+    }
+
+    void update(ram_ledger& ram, uint64_t receiver, int32_t itr, uint64_t payer, const void* data, size_t len) {
+        const auto& [tab, id] = _iterators.at(itr);
+        check(std::get<0>(tab->first) == receiver, "db access violation");
+
+        auto& value = row_at(itr);
+        remember(tab, id);
+        const auto new_payer = payer == 0u ? value.payer : payer;
+        ram.bill(value.payer, -(billing::primary_row + int64_t(value.data.size())));
+        ram.bill(new_payer, billing::primary_row + int64_t(len));
+
+        const auto* bytes = static_cast<const char*>(data);
+        value.data.assign(bytes, bytes + len);
+        value.payer = new_payer;
+    }
+
+    void remove(ram_ledger& ram, uint64_t receiver, int32_t itr) {
+        const auto& [tab, id] = _iterators.at(itr);
+        check(std::get<0>(tab->first) == receiver, "db access violation");
+
+        auto& rows = tab->second.rows;
+        const auto pos = lower(rows, id);
+        check(pos != rows.end() && pos->primary == id, "dereference of deleted object");
+
+        remember(tab, id);
+        ram.bill(pos->payer, -(billing::primary_row + int64_t(pos->data.size())));
+        rows.erase(pos);
+        if (rows.empty()) {
+            ram.bill(tab->second.payer, -billing::table);
+        }
+    }
+
+    int32_t get(int32_t itr, void* data, size_t len) {
+        const auto& value = row_at(itr).data;
+        if (len != 0u) {
+            std::memcpy(data, value.data(), std::min(len, value.size()));
+        }
+        return static_cast<int32_t>(value.size());
+    }
+
+    int32_t next(int32_t itr, uint64_t* primary) {
+        if (itr < -1) {
+            return -1; // next of end
+        }
+        const auto& [tab, id] = _iterators.at(itr);
+        const auto& rows = tab->second.rows;
+        const auto next = std::upper_bound(
+            rows.begin(), rows.end(), id, [](uint64_t value, const row& r) { return value < r.primary; });
+        if (next == rows.end()) {
+            return _iterators.end_of(tab);
+        }
+        *primary = next->primary;
+        return _iterators.add(tab, next->primary);
+    }
+
+    int32_t previous(int32_t itr, uint64_t* primary) {
+        auto tab = itr < -1 ? _iterators.table_of_end(itr) : _iterators.at(itr).first;
+        auto& rows = tab->second.rows;
+        const auto current = itr < -1 ? rows.end() : lower(rows, _iterators.at(itr).second);
+        if (current == rows.begin()) {
+            return -1;
+        }
+        *primary = std::prev(current)->primary;
+        return _iterators.add(tab, *primary);
+    }
+
+    int32_t find(uint64_t code, uint64_t scope, uint64_t table_name, uint64_t id) {
+        const auto tab = find_table(code, scope, table_name);
+        if (tab == _tables.end()) {
+            return -1;
+        }
+        const auto pos = lower(tab->second.rows, id);
+        return pos == tab->second.rows.end() || pos->primary != id ? _iterators.end_of(tab) : _iterators.add(tab, id);
+    }
+
+    int32_t lowerbound(uint64_t code, uint64_t scope, uint64_t table_name, uint64_t id) {
+        const auto tab = find_table(code, scope, table_name);
+        if (tab == _tables.end()) {
+            return -1;
+        }
+        const auto pos = lower(tab->second.rows, id);
+        return pos == tab->second.rows.end() ? _iterators.end_of(tab) : _iterators.add(tab, pos->primary);
+    }
+
+    int32_t upperbound(uint64_t code, uint64_t scope, uint64_t table_name, uint64_t id) {
+        const auto tab = find_table(code, scope, table_name);
+        if (tab == _tables.end()) {
+            return -1;
+        }
+        const auto& rows = tab->second.rows;
+        const auto pos = std::upper_bound(
+            rows.begin(), rows.end(), id, [](uint64_t value, const row& r) { return value < r.primary; });
+        return pos == rows.end() ? _iterators.end_of(tab) : _iterators.add(tab, pos->primary);
+    }
+
+    int32_t end(uint64_t code, uint64_t scope, uint64_t table_name) {
+        const auto tab = find_table(code, scope, table_name);
+        return tab == _tables.end() ? -1 : _iterators.end_of(tab);
+    }
+
+    const tables_t& tables() const { return _tables; }
+
+    void clear_iterators() { _iterators.clear(); }
+
+    void start_undo() {
+        _undo.clear();
+        _recording = true;
+    }
+
+    void commit_undo() {
+        _undo.clear();
+        _recording = false;
+    }
+
+    /* reverts changes of undo session in reverse order */
+    void undo() {
+        for (auto it = _undo.rbegin(); it != _undo.rend(); ++it) {
+            auto& tab = _tables[it->table];
+            tab.payer = it->table_payer;
+
+            auto& rows = tab.rows;
+            const auto pos = lower(rows, it->primary);
+            const auto exists = pos != rows.end() && pos->primary == it->primary;
+            if (it->prev && exists) {
+                *pos = std::move(*it->prev);
+            } else if (it->prev) {
+                rows.insert(pos, std::move(*it->prev));
+            } else if (exists) {
+                rows.erase(pos);
+            }
+        }
+        commit_undo();
+    }
+
+  private:
+    /* row before change, absent for new row */
+    struct undo_entry {
+        table_key table;
+        uint64_t table_payer;
+        uint64_t primary;
+        std::optional<row> prev;
+    };
+
+    void remember(tables_t::iterator tab, uint64_t id) {
+        if (!_recording) {
+            return;
+        }
+        auto& rows = tab->second.rows;
+        const auto pos = lower(rows, id);
+        auto prev = pos != rows.end() && pos->primary == id ? std::optional<row>(*pos) : std::nullopt;
+        _undo.push_back(undo_entry{tab->first, tab->second.payer, id, std::move(prev)});
+    }
+
+    static std::vector<row>::iterator lower(std::vector<row>& rows, uint64_t id) {
+        return std::lower_bound(
+            rows.begin(), rows.end(), id, [](const row& r, uint64_t value) { return r.primary < value; });
+    }
+
+    tables_t::iterator find_table(uint64_t code, uint64_t scope, uint64_t table_name) {
+        const auto tab = _tables.find(table_key{code, scope, table_name});
+        return tab == _tables.end() || tab->second.rows.empty() ? _tables.end() : tab;
+    }
+
+    row& row_at(int32_t itr) {
+        const auto& [tab, id] = _iterators.at(itr);
+        const auto pos = lower(tab->second.rows, id);
+        check(pos != tab->second.rows.end() && pos->primary == id, "dereference of deleted object");
+        return *pos;
+    }
+
+  private:
+    tables_t _tables;
+    iterator_cache<tables_t::iterator, uint64_t> _iterators;
+
+    bool _recording{false};
+    std::vector<undo_entry> _undo;
+};
+
+// =============================================================
+// Secondary index, one instance per secondary key type
+// =============================================================
+template <typename Secondary> class secondary_index {
+  public:
+    struct entry {
+        Secondary secondary;
+        uint64_t primary;
+        uint64_t payer;
+
+        bool operator<(const std::pair<Secondary, uint64_t>& key) const {
+            return std::tie(secondary, primary) < std::tie(key.first, key.second);
+        }
+    };
+
+    struct table {
+        uint64_t payer{0u};
+        std::vector<entry> entries;                       // sorted by (secondary, primary)
+        std::vector<std::pair<uint64_t, Secondary>> keys; // sorted by primary
+    };
+
+    using tables_t = std::map<table_key, table>;
+    using key_t = std::pair<Secondary, uint64_t>;
+
+  public:
+    int32_t store(ram_ledger& ram,
+                  uint64_t receiver,
+                  uint64_t scope,
+                  uint64_t table_name,
+                  uint64_t payer,
+                  uint64_t id,
+                  const Secondary& secondary) {
+        check(payer != 0u, "must specify a valid account to pay for new record");
+
+        auto tab = _tables.try_emplace(table_key{receiver, scope, table_name}).first;
+        auto& entries = tab->second.entries;
+        auto& keys = tab->second.keys;
+        const auto key_pos = lower_primary(keys, id);
+        check(key_pos == keys.end() || key_pos->first != id, "secondary key already exists for this primary key");
+
+        remember(tab, id);
+        if (entries.empty()) {
+            tab->second.payer = payer;
+            ram.bill(payer, billing::table);
+        }
+
+        keys.emplace(key_pos, id, secondary);
+        entries.insert(std::lower_bound(entries.begin(), entries.end(), key_t{secondary, id}),
+                       entry{secondary, id, payer});
+        ram.bill(payer, billing::secondary_row<Secondary>);
+
+        return _iterators.add(tab, key_t{secondary, id});
+    }
+
+    void update(ram_ledger& ram, uint64_t receiver, int32_t itr, uint64_t payer, const Secondary& secondary) {
+        const auto [tab, key] = _iterators.at(itr);
+        check(std::get<0>(tab->first) == receiver, "db access violation");
+
+        auto& entries = tab->second.entries;
+        const auto pos = find_entry(entries, key);
+        remember(tab, key.second);
+        const auto new_payer = payer == 0u ? pos->payer : payer;
+        ram.bill(pos->payer, -billing::secondary_row<Secondary>);
+        ram.bill(new_payer, billing::secondary_row<Secondary>);
+
+        entries.erase(pos);
+        entries.insert(std::lower_bound(entries.begin(), entries.end(), key_t{secondary, key.second}),
+                       entry{secondary, key.second, new_payer});
+        lower_primary(tab->second.keys, key.second)->second = secondary;
+    }
+
+    void remove(ram_ledger& ram, uint64_t receiver, int32_t itr) {
+        const auto [tab, key] = _iterators.at(itr);
+        check(std::get<0>(tab->first) == receiver, "db access violation");
+
+        auto& entries = tab->second.entries;
+        const auto pos = find_entry(entries, key);
+        remember(tab, key.second);
+        ram.bill(pos->payer, -billing::secondary_row<Secondary>);
+
+        entries.erase(pos);
+        tab->second.keys.erase(lower_primary(tab->second.keys, key.second));
+        if (entries.empty()) {
+            ram.bill(tab->second.payer, -billing::table);
+        }
+    }
+
+    int32_t next(int32_t itr, uint64_t* primary) {
+        if (itr < -1) {
+            return -1; // next of end
+        }
+        const auto& [tab, key] = _iterators.at(itr);
+        const auto& entries = tab->second.entries;
+        const auto next = std::next(find_entry(tab->second.entries, key));
+        if (next == entries.end()) {
+            return _iterators.end_of(tab);
+        }
+        *primary = next->primary;
+        return _iterators.add(tab, key_t{next->secondary, next->primary});
+    }
+
+    int32_t previous(int32_t itr, uint64_t* primary) {
+        auto tab = itr < -1 ? _iterators.table_of_end(itr) : _iterators.at(itr).first;
+        auto& entries = tab->second.entries;
+        const auto current = itr < -1 ? entries.end() : find_entry(entries, _iterators.at(itr).second);
+        if (current == entries.begin()) {
+            return -1;
+        }
+        const auto prev = std::prev(current);
+        *primary = prev->primary;
+        return _iterators.add(tab, key_t{prev->secondary, prev->primary});
+    }
+
+    int32_t find_primary(uint64_t code, uint64_t scope, uint64_t table_name, Secondary* secondary, uint64_t primary) {
+        const auto tab = find_table(code, scope, table_name);
+        if (tab == _tables.end()) {
+            return -1;
+        }
+        const auto pos = lower_primary(tab->second.keys, primary);
+        if (pos == tab->second.keys.end() || pos->first != primary) {
+            return _iterators.end_of(tab);
+        }
+        *secondary = pos->second;
+        return _iterators.add(tab, key_t{pos->second, primary});
+    }
+
+    int32_t
+    find_secondary(uint64_t code, uint64_t scope, uint64_t table_name, const Secondary* secondary, uint64_t* primary) {
+        const auto tab = find_table(code, scope, table_name);
+        if (tab == _tables.end()) {
+            return -1;
+        }
+        const auto& entries = tab->second.entries;
+        const auto pos = std::lower_bound(entries.begin(), entries.end(), key_t{*secondary, 0u});
+        if (pos == entries.end() || pos->secondary != *secondary) {
+            return _iterators.end_of(tab);
+        }
+        *primary = pos->primary;
+        return _iterators.add(tab, key_t{pos->secondary, pos->primary});
+    }
+
+    int32_t lowerbound(uint64_t code, uint64_t scope, uint64_t table_name, Secondary* secondary, uint64_t* primary) {
+        const auto tab = find_table(code, scope, table_name);
+        if (tab == _tables.end()) {
+            return -1;
+        }
+        const auto& entries = tab->second.entries;
+        return found(tab, std::lower_bound(entries.begin(), entries.end(), key_t{*secondary, 0u}), secondary, primary);
+    }
+
+    int32_t upperbound(uint64_t code, uint64_t scope, uint64_t table_name, Secondary* secondary, uint64_t* primary) {
+        const auto tab = find_table(code, scope, table_name);
+        if (tab == _tables.end()) {
+            return -1;
+        }
+        const auto& entries = tab->second.entries;
+        const auto pos = std::upper_bound(entries.begin(), entries.end(), *secondary, [](const Secondary& value, const entry& e) {
+            return value < e.secondary;
+        });
+        return found(tab, pos, secondary, primary);
+    }
+
+    int32_t end(uint64_t code, uint64_t scope, uint64_t table_name) {
+        const auto tab = find_table(code, scope, table_name);
+        return tab == _tables.end() ? -1 : _iterators.end_of(tab);
+    }
+
+    const tables_t& tables() const { return _tables; }
+
+    void clear_iterators() { _iterators.clear(); }
+
+    void start_undo() {
+        _undo.clear();
+        _recording = true;
+    }
+
+    void commit_undo() {
+        _undo.clear();
+        _recording = false;
+    }
+
+    /* reverts changes of undo session in reverse order */
+    void undo() {
+        for (auto it = _undo.rbegin(); it != _undo.rend(); ++it) {
+            auto& tab = _tables[it->table];
+            tab.payer = it->table_payer;
+
+            auto& keys = tab.keys;
+            auto& entries = tab.entries;
+            const auto key_pos = lower_primary(keys, it->primary);
+            if (key_pos != keys.end() && key_pos->first == it->primary) {
+                entries.erase(find_entry(entries, key_t{key_pos->second, it->primary}));
+                keys.erase(key_pos);
+            }
+            if (it->prev) {
+                keys.emplace(lower_primary(keys, it->primary), it->primary, it->prev->secondary);
+                entries.insert(std::lower_bound(entries.begin(), entries.end(), key_t{it->prev->secondary, it->primary}),
+                               *it->prev);
+            }
+        }
+        commit_undo();
+    }
+
+  private:
+    using tab_ref = typename tables_t::iterator;
+    using entries_iterator = typename std::vector<entry>::const_iterator;
+
+    /* entry before change, absent for new entry */
+    struct undo_entry {
+        table_key table;
+        uint64_t table_payer;
+        uint64_t primary;
+        std::optional<entry> prev;
+    };
+
+    void remember(tab_ref tab, uint64_t id) {
+        if (!_recording) {
+            return;
+        }
+        auto& keys = tab->second.keys;
+        const auto key_pos = lower_primary(keys, id);
+        std::optional<entry> prev;
+        if (key_pos != keys.end() && key_pos->first == id) {
+            prev = *find_entry(tab->second.entries, key_t{key_pos->second, id});
+        }
+        _undo.push_back(undo_entry{tab->first, tab->second.payer, id, std::move(prev)});
+    }
+
+    static typename std::vector<std::pair<uint64_t, Secondary>>::iterator
+    lower_primary(std::vector<std::pair<uint64_t, Secondary>>& keys, uint64_t id) {
+        return std::lower_bound(
+            keys.begin(), keys.end(), id, [](const auto& item, uint64_t value) { return item.first < value; });
+    }
+
+    static typename std::vector<entry>::iterator find_entry(std::vector<entry>& entries, const key_t& key) {
+        const auto pos = std::lower_bound(entries.begin(), entries.end(), key);
+        check(pos != entries.end() && pos->primary == key.second && !(pos->secondary < key.first) &&
+                  !(key.first < pos->secondary),
+              "dereference of deleted object");
+        return pos;
+    }
+
+    tab_ref find_table(uint64_t code, uint64_t scope, uint64_t table_name) {
+        const auto tab = _tables.find(table_key{code, scope, table_name});
+        return tab == _tables.end() || tab->second.entries.empty() ? _tables.end() : tab;
+    }
+
+    int32_t found(tab_ref tab, entries_iterator pos, Secondary* secondary, uint64_t* primary) {
+        if (pos == tab->second.entries.end()) {
+            return _iterators.end_of(tab);
+        }
+        *secondary = pos->secondary;
+        *primary = pos->primary;
+        return _iterators.add(tab, key_t{pos->secondary, pos->primary});
+    }
+
+  private:
+    tables_t _tables;
+    iterator_cache<tab_ref, key_t> _iterators;
+
+    bool _recording{false};
+    std::vector<undo_entry> _undo;
+};
+
+/* all indices of native chain, action changes are reverted by undo session */
+struct native_db {
+    primary_index primary;
+    secondary_index<uint64_t> idx64;
+    secondary_index<unsigned __int128> idx128;
+    secondary_index<key256> idx256;
+    secondary_index<double> idx_double;
+    secondary_index<long double> idx_long_double;
+    ram_ledger ram;
+
+    void clear_iterators() {
+        primary.clear_iterators();
+        idx64.clear_iterators();
+        idx128.clear_iterators();
+        idx256.clear_iterators();
+        idx_double.clear_iterators();
+        idx_long_double.clear_iterators();
+    }
+
+    /* starts logging changed rows, session ends by `commit_undo` or `undo` */
+    void start_undo() {
+        primary.start_undo();
+        idx64.start_undo();
+        idx128.start_undo();
+        idx256.start_undo();
+        idx_double.start_undo();
+        idx_long_double.start_undo();
+        ram.start_undo();
+    }
+
+    void commit_undo() {
+        primary.commit_undo();
+        idx64.commit_undo();
+        idx128.commit_undo();
+        idx256.commit_undo();
+        idx_double.commit_undo();
+        idx_long_double.commit_undo();
+        ram.commit_undo();
+    }
+
+    void undo() {
+        primary.undo();
+        idx64.undo();
+        idx128.undo();
+        idx256.undo();
+        idx_double.undo();
+        idx_long_double.undo();
+        ram.undo();
+        clear_iterators();
+    }
+};
+
+} // namespace game_sim
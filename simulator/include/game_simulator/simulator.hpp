@@ -0,0 +1,452 @@
+#pragma once
+
+#include <game-contract-sdk/game_base.hpp>
+
+#include <game_simulator/native_chain.hpp>
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <set>
+#include <thread>
+
+/* game contract entry point, defined by `GAME_CONTRACT` macro */
+extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action);
+
+namespace game_sim {
+
+using eosio::asset;
+using eosio::checksum256;
+using eosio::name;
+using game_sdk::game_params_type;
+using game_sdk::param_t;
+using events = game_sdk::game::events;
+
+/* player's answer to `action_request` event */
+struct player_action {
+    uint16_t type;
+    std::vector<param_t> params;
+    std::optional<asset> deposit{}; // transferred to session right before action
+};
+
+using player_t = std::function<player_action(const events::action_request&, std::mt19937_64&)>;
+
+struct round_result {
+    asset bet; // total deposit, including deposits made with actions
+    asset payout; // total transferred to player, including returned deposit
+    bool failed;
+};
+
+/**
+   Native game simulator, drives game contract compiled for host without chain.
+   Platform, casino and token contracts aren't executed: their tables are seeded with rows
+   of single game, casino and core token, so game reads them the same way as on chain.
+   Inline actions are only inspected to catch events and payouts to player. Signidice signs are random strings, every sign is valid.
+   Simulator binds itself to the creating thread, so it should be created and used in the same thread.
+*/
+class simulator {
+  public:
+    static constexpr name platform_name = "platform"_n;
+    static constexpr name events_name = "events"_n;
+    static constexpr name casino_name = "casino"_n;
+    static constexpr name token_name = "eosio.token"_n;
+    static constexpr name player_name = "player"_n;
+
+    static constexpr uint64_t game_id = 0u;
+    static constexpr uint64_t casino_id = 0u;
+    static constexpr uint32_t session_ttl = 600u;
+
+  public:
+    using event_t = std::pair<uint32_t, std::vector<char>>; // type, data
+
+    /* copy of chain and session bookkeeping, see `save` and `restore` */
+    struct snapshot {
+        native_db db;
+        uint64_t now;
+        uint64_t ses_seq;
+        std::map<uint64_t, event_t> events;
+        asset payout;
+        asset deposited;
+    };
+
+  public:
+    simulator(name game, const game_params_type& params, uint64_t seed)
+        : _game(game), _rng(seed), _payout(0, game_sdk::game::core_symbol),
+          _deposited(0, game_sdk::game::core_symbol) {
+        native_chain::current() = &_chain;
+
+        seed_platform(params);
+        push_action("init"_n, platform_name, events_name, session_ttl);
+    }
+
+    ~simulator() {
+        if (native_chain::current() == &_chain) {
+            native_chain::current() = nullptr;
+        }
+    }
+
+    simulator(const simulator&) = delete;
+    simulator& operator=(const simulator&) = delete;
+
+    /* pushes game's own action */
+    template <typename... Args> void push_action(name action, Args&&... args) {
+        push_action_from(_game, action, std::forward<Args>(args)...);
+    }
+
+    /* pushes action to game as notification from `code` contract, e.g. token transfer */
+    template <typename... Args> void push_action_from(name code, name action, Args&&... args) {
+        auto data = eosio::pack(std::make_tuple(std::forward<Args>(args)...));
+        _action_requests.clear();
+        for (const auto& act : _chain.push_action(&::apply, _game.value, code.value, action.value, std::move(data))) {
+            handle_inline_action(act);
+        }
+
+        // platform answers random prefetch at once, player's action request stays pending
+        while (!_prefetches.empty()) {
+            const auto ses_id = _prefetches.back();
+            _prefetches.pop_back();
+            signidice_part_1(ses_id);
+        }
+    }
+
+    uint64_t new_session(const asset& deposit) {
+        const auto ses_id = _ses_seq++;
+        transfer(ses_id, deposit);
+        push_action("newgame"_n, ses_id, casino_id);
+        return ses_id;
+    }
+
+    /* player's transfer to session */
+    void transfer(uint64_t ses_id, const asset& quantity) {
+        push_action_from(token_name, "transfer"_n, player_name, _game, quantity, std::to_string(ses_id));
+        _deposited += quantity;
+    }
+
+    void game_action(uint64_t ses_id, uint16_t type, const std::vector<param_t>& params) {
+        push_action("gameaction"_n, ses_id, type, params);
+    }
+
+    void signidice_part_1(uint64_t ses_id) { push_action("sgdicefirst"_n, ses_id, random_sign()); }
+
+    void signidice_part_2(uint64_t ses_id) { push_action("sgdicesecond"_n, ses_id, random_sign()); }
+
+    /* finishes signidice with predefined result, `on_random` receives `digest` */
+    void signidice_part_2(uint64_t ses_id, const checksum256& digest) {
+        const auto sign = random_sign();
+        _chain.program_sha256(sign, digest.extract_as_byte_array());
+        try {
+            push_action("sgdicesecond"_n, ses_id, sign);
+        } catch (...) {
+            _chain.clear_programmed_sha256();
+            throw;
+        }
+        _chain.clear_programmed_sha256();
+    }
+
+    /* applies player's answer to action request */
+    void player_move(uint64_t ses_id, const player_action& action) {
+        if (action.deposit) {
+            transfer(ses_id, *action.deposit);
+        }
+        game_action(ses_id, action.type, action.params);
+    }
+
+    /* plays session from deposit to `game_finished` or `game_failed` event */
+    round_result play_round(const asset& bet, const player_t& player, uint32_t step_limit = 100u) {
+        _payout = asset(0, bet.symbol);
+        _deposited = asset(0, bet.symbol);
+        const auto ses_id = new_session(bet);
+
+        for (uint32_t step = 0; step != step_limit; ++step) {
+            const auto event = take_event(ses_id);
+
+            switch (event.first) {
+            case events::action_request::type: {
+                player_move(ses_id, player(eosio::unpack<events::action_request>(event.second), _rng));
+                break;
+            }
+            case events::signidice_part_1_request::type:
+                signidice_part_1(ses_id);
+                break;
+            case events::signidice_part_2_request::type:
+                signidice_part_2(ses_id);
+                break;
+            case events::game_finished::type:
+                return round_result{_deposited, _payout, false};
+            case events::game_failed::type:
+                return round_result{_deposited, _payout, true};
+            default:
+                throw std::logic_error("unexpected event type: " + std::to_string(event.first));
+            }
+        }
+
+        throw std::runtime_error("round step limit exceeded");
+    }
+
+    /* last state event of session, nullptr if game requested nothing */
+    const event_t* pending_event(uint64_t ses_id) const {
+        const auto it = _events.find(ses_id);
+        return it != _events.end() ? &it->second : nullptr;
+    }
+
+    /* total transferred to player and deposited by player since round start */
+    const asset& payout() const { return _payout; }
+
+    const asset& deposited() const { return _deposited; }
+
+    snapshot save() const {
+        return snapshot{_chain.db(), _chain.now(), _ses_seq, _events, _payout, _deposited};
+    }
+
+    void restore(const snapshot& state) {
+        _chain.db() = state.db;
+        _chain.db().clear_iterators();
+        _chain.set_now(state.now);
+        _ses_seq = state.ses_seq;
+        _events = state.events;
+        _payout = state.payout;
+        _deposited = state.deposited;
+    }
+
+    name game() const { return _game; }
+
+    native_chain& chain() { return _chain; }
+
+    std::mt19937_64& rng() { return _rng; }
+
+  private:
+    static std::string core_token() { return game_sdk::game::core_symbol.code().to_string(); }
+
+    /* token stats of `eosio.token`, read by `token::get_symbol` */
+    struct currency_stats {
+        asset supply;
+        asset max_supply;
+        name issuer;
+
+        uint64_t primary_key() const { return supply.symbol.code().raw(); }
+    };
+
+    using token_stats = eosio::multi_index<"stat"_n, currency_stats>;
+
+    /* rows which platform and casino contracts have after `addgame`, `addcas` and `addtoken` */
+    void seed_platform(const game_params_type& params) {
+        const auto core_symbol = game_sdk::game::core_symbol;
+
+        _chain.as_contract(platform_name.value, [&]() {
+            platform::global_singleton global(platform_name, platform_name.value);
+            auto state = global.get_or_default();
+            state.games_seq = game_id + 1;
+            global.set(state, platform_name);
+
+            platform::game_table games(platform_name, platform_name.value);
+            games.emplace(platform_name, [&](auto& row) {
+                row.id = game_id;
+                row.contract = _game;
+                row.params_cnt = static_cast<uint16_t>(params.size());
+                row.paused = false;
+            });
+
+            platform::casino_table casinos(platform_name, platform_name.value);
+            casinos.emplace(platform_name, [&](auto& row) {
+                row.id = casino_id;
+                row.contract = casino_name;
+                row.paused = false;
+            });
+
+            platform::token_table tokens(platform_name, platform_name.value);
+            tokens.emplace(platform_name, [&](auto& row) {
+                row.token_name = core_token();
+                row.contract = token_name;
+            });
+        });
+
+        // no game params rows: game falls back to legacy params of casino's game row for core token
+        _chain.as_contract(casino_name.value, [&]() {
+            casino::game_table games(casino_name, casino_name.value);
+            games.emplace(casino_name, [&](auto& row) {
+                row.game_id = game_id;
+                row.paused = false;
+                row.params = params;
+            });
+
+            casino::token_table tokens(casino_name, casino_name.value);
+            tokens.emplace(casino_name, [&](auto& row) {
+                row.token_name = core_token();
+                row.paused = false;
+            });
+        });
+
+        _chain.as_contract(token_name.value, [&]() {
+            token_stats stats(token_name, core_symbol.code().raw());
+            stats.emplace(token_name, [&](auto& row) {
+                row.supply = asset(0, core_symbol);
+                row.max_supply = asset(asset::max_amount, core_symbol);
+                row.issuer = token_name;
+            });
+        });
+    }
+
+    void handle_inline_action(const inline_action& act) {
+        if (act.account == events_name.value && act.name == "send"_n.value) {
+            const auto [sender, cas_id, gm_id, ses_id, type, data] =
+                eosio::unpack<std::tuple<name, uint64_t, uint64_t, uint64_t, uint32_t, std::vector<char>>>(act.data);
+
+            // random requested after player's action request is prefetch for next action
+            const auto prefetch =
+                type == events::signidice_part_1_request::type && _action_requests.count(ses_id) != 0;
+            if (type == events::action_request::type) {
+                _action_requests.insert(ses_id);
+            }
+
+            // game flow is driven by SDK state events only
+            if (prefetch) {
+                _prefetches.push_back(ses_id);
+            } else if (type < game_sdk::first_custom_event_type && type != events::game_started::type &&
+                       type != events::game_message::type && type != events::round_finished::type) {
+                _events[ses_id] = event_t{type, data};
+            }
+        } else if (act.account == token_name.value && act.name == "transfer"_n.value) {
+            const auto [from, to, quantity, memo] =
+                eosio::unpack<std::tuple<name, name, asset, std::string>>(act.data);
+            if (to == player_name) {
+                _payout += quantity;
+            }
+        } else if (act.account == casino_name.value && act.name == "onloss"_n.value) {
+            const auto [game, to, quantity] = eosio::unpack<std::tuple<name, name, asset>>(act.data);
+            if (to == player_name) {
+                _payout += quantity;
+            }
+        }
+    }
+
+    event_t take_event(uint64_t ses_id) {
+        const auto it = _events.find(ses_id);
+        if (it == _events.end()) {
+            throw std::logic_error("game didn't request next step for session " + std::to_string(ses_id));
+        }
+        auto event = std::move(it->second);
+        _events.erase(it);
+        return event;
+    }
+
+    std::string random_sign() {
+        static constexpr char hex[] = "0123456789abcdef";
+        std::string sign(64, '0');
+        for (size_t i = 0; i != sign.size(); i += 16) {
+            auto value = _rng();
+            for (size_t j = 0; j != 16; ++j, value >>= 4) {
+                sign[i + j] = hex[value & 0x0f];
+            }
+        }
+        return sign;
+    }
+
+  private:
+    native_chain _chain;
+    name _game;
+    std::mt19937_64 _rng;
+
+    uint64_t _ses_seq{0u};
+    std::map<uint64_t, event_t> _events; // ses_id -> last state event
+    std::set<uint64_t> _action_requests; // sessions requested player's action by last action
+    std::vector<uint64_t> _prefetches;   // sessions with random prefetch requested by last action
+    asset _payout;
+    asset _deposited;
+};
+
+/* Aggregated results of simulated rounds */
+struct stats {
+    uint64_t rounds{0u};
+    uint64_t failed{0u};
+    long double total_bet{0.};
+    long double total_payout{0.};
+    std::vector<int64_t> payouts; // payout amount of every round, filled if recording is enabled
+
+    double rtp() const { return total_bet > 0. ? double(total_payout / total_bet) : 0.; }
+
+    void add(const round_result& result, bool record_payout) {
+        rounds++;
+        failed += result.failed ? 1u : 0u;
+        total_bet += result.bet.amount;
+        total_payout += result.payout.amount;
+        if (record_payout) {
+            payouts.push_back(result.payout.amount);
+        }
+    }
+
+    void merge(stats&& other) {
+        rounds += other.rounds;
+        failed += other.failed;
+        total_bet += other.total_bet;
+        total_payout += other.total_payout;
+        payouts.insert(payouts.end(), other.payouts.begin(), other.payouts.end());
+    }
+};
+
+struct run_config {
+    uint64_t rounds{1000000u};
+    uint32_t workers{std::max(std::thread::hardware_concurrency(), 1u)};
+    uint64_t seed{0u};
+    bool record_payouts{false};
+};
+
+using simulator_factory_t = std::function<std::unique_ptr<simulator>(uint64_t seed)>;
+
+/**
+   Plays `config.rounds` rounds on `config.workers` threads.
+   Rounds are split into fixed size chunks, chunk `i` is played by own simulator with seed `config.seed + i`
+   and workers take chunks round-robin, so result of the same config is reproducible for any number of workers.
+*/
+inline stats run(const simulator_factory_t& factory,
+                 const asset& bet,
+                 const player_t& player,
+                 const run_config& config = run_config{}) {
+    static constexpr uint64_t chunk_size = 1024u;
+
+    const auto chunks = (config.rounds + chunk_size - 1) / chunk_size;
+    std::vector<stats> results(chunks);
+    std::vector<std::exception_ptr> errors(config.workers);
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed{false};
+
+    for (uint32_t worker = 0; worker != config.workers; ++worker) {
+        threads.emplace_back([&, worker]() {
+            try {
+                for (auto chunk = uint64_t(worker); chunk < chunks && !failed; chunk += config.workers) {
+                    auto sim = factory(config.seed + chunk);
+
+                    const auto last = std::min((chunk + 1) * chunk_size, config.rounds);
+                    for (auto round = chunk * chunk_size; round != last; ++round) {
+                        results[chunk].add(sim->play_round(bet, player), config.record_payouts);
+                    }
+                }
+            } catch (...) {
+                errors[worker] = std::current_exception();
+                failed = true; // stop other workers
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // chunks are merged in order, so recorded payouts don't depend on scheduling
+    stats result;
+    for (auto& chunk_stats : results) {
+        result.merge(std::move(chunk_stats));
+    }
+    return result;
+}
+
+} // namespace game_sim
@@ -0,0 +1,297 @@
+#include <game_simulator/native_chain.hpp>
+
+#include <openssl/sha.h>
+
+#include <string>
+
+/*
+ Host definitions of eosio intrinsics used by game contracts.
+ Every call is forwarded to chain bound to calling thread.
+ Authorization intrinsics are permissive: actions are pushed by simulation host directly.
+*/
+
+using game_sim::native_chain;
+
+extern "C" {
+
+struct __attribute__((aligned(16))) capi_checksum256 {
+    uint8_t hash[32];
+};
+
+// =============================================================
+// System
+// =============================================================
+void eosio_assert(uint32_t test, const char* msg) {
+    if (!test) {
+        throw game_sim::assert_error(msg);
+    }
+}
+
+void eosio_assert_message(uint32_t test, const char* msg, uint32_t msg_len) {
+    if (!test) {
+        throw game_sim::assert_error(std::string(msg, msg_len));
+    }
+}
+
+void eosio_assert_code(uint32_t test, uint64_t code) {
+    if (!test) {
+        throw game_sim::assert_error("assertion failure with error code: " + std::to_string(code));
+    }
+}
+
+void eosio_exit(int32_t code) { throw game_sim::exit_signal{code}; }
+
+uint64_t current_time() { return native_chain::get().now(); }
+
+uint64_t publication_time() { return native_chain::get().now(); }
+
+// =============================================================
+// Action
+// =============================================================
+uint32_t read_action_data(void* msg, uint32_t len) {
+    const auto& data = native_chain::get().action_data();
+    const auto size = std::min<size_t>(len, data.size());
+    std::memcpy(msg, data.data(), size);
+    return static_cast<uint32_t>(size);
+}
+
+uint32_t action_data_size() { return static_cast<uint32_t>(native_chain::get().action_data().size()); }
+
+uint64_t current_receiver() { return native_chain::get().receiver(); }
+
+void require_recipient(uint64_t) {}
+
+void require_auth(uint64_t) {}
+
+void require_auth2(uint64_t, uint64_t) {}
+
+bool has_auth(uint64_t) { return true; }
+
+bool is_account(uint64_t) { return true; }
+
+void send_inline(char* serialized_action, size_t size) { native_chain::get().send_inline(serialized_action, size); }
+
+void send_context_free_inline(char* serialized_action, size_t size) {
+    native_chain::get().send_inline(serialized_action, size);
+}
+
+// =============================================================
+// Crypto
+// =============================================================
+void sha256(const char* data, uint32_t length, capi_checksum256* hash) {
+    // hashing doesn't need chain, e.g. PRNG used outside of simulation
+    const auto* chain = native_chain::current();
+    if (const auto* digest = chain ? chain->programmed_sha256(data, length) : nullptr) {
+        std::memcpy(hash->hash, digest->data(), digest->size());
+        return;
+    }
+    SHA256(reinterpret_cast<const unsigned char*>(data), length, hash->hash);
+}
+
+void assert_sha256(const char* data, uint32_t length, const capi_checksum256* hash) {
+    capi_checksum256 result;
+    sha256(data, length, &result);
+    game_sim::check(std::memcmp(result.hash, hash->hash, sizeof(result.hash)) == 0, "hash mismatch");
+}
+
+/* signidice signs are produced by simulation host, so every sign is valid */
+int rsa_verify(const capi_checksum256*, const char*, size_t, const char*, size_t) { return 1; }
+
+// =============================================================
+// Print
+// =============================================================
+void prints(const char* cstr) { native_chain::get().print(cstr, std::strlen(cstr)); }
+
+void prints_l(const char* cstr, uint32_t len) { native_chain::get().print(cstr, len); }
+
+void printi(int64_t value) {
+    const auto str = std::to_string(value);
+    native_chain::get().print(str.data(), str.size());
+}
+
+void printui(uint64_t value) {
+    const auto str = std::to_string(value);
+    native_chain::get().print(str.data(), str.size());
+}
+
+void printi128(const __int128* value) { printi(static_cast<int64_t>(*value)); }
+
+void printui128(const unsigned __int128* value) { printui(static_cast<uint64_t>(*value)); }
+
+void printsf(float value) {
+    const auto str = std::to_string(value);
+    native_chain::get().print(str.data(), str.size());
+}
+
+void printdf(double value) {
+    const auto str = std::to_string(value);
+    native_chain::get().print(str.data(), str.size());
+}
+
+void printqf(const long double* value) {
+    const auto str = std::to_string(*value);
+    native_chain::get().print(str.data(), str.size());
+}
+
+void printn(uint64_t value) { printui(value); }
+
+void printhex(const void* data, uint32_t datalen) {
+    static constexpr char hex[] = "0123456789abcdef";
+    std::string str;
+    for (uint32_t i = 0; i != datalen; ++i) {
+        const auto byte = static_cast<const uint8_t*>(data)[i];
+        str += hex[byte >> 4];
+        str += hex[byte & 0x0f];
+    }
+    native_chain::get().print(str.data(), str.size());
+}
+
+// =============================================================
+// Database, primary index
+// =============================================================
+int32_t db_store_i64(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const void* data, uint32_t len) {
+    auto& chain = native_chain::get();
+    return chain.db().primary.store(chain.ram(), chain.receiver(), scope, table, payer, id, data, len);
+}
+
+void db_update_i64(int32_t iterator, uint64_t payer, const void* data, uint32_t len) {
+    auto& chain = native_chain::get();
+    chain.db().primary.update(chain.ram(), chain.receiver(), iterator, payer, data, len);
+}
+
+void db_remove_i64(int32_t iterator) {
+    auto& chain = native_chain::get();
+    chain.db().primary.remove(chain.ram(), chain.receiver(), iterator);
+}
+
+int32_t db_get_i64(int32_t iterator, void* data, uint32_t len) {
+    return native_chain::get().db().primary.get(iterator, data, len);
+}
+
+int32_t db_next_i64(int32_t iterator, uint64_t* primary) {
+    return native_chain::get().db().primary.next(iterator, primary);
+}
+
+int32_t db_previous_i64(int32_t iterator, uint64_t* primary) {
+    return native_chain::get().db().primary.previous(iterator, primary);
+}
+
+int32_t db_find_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+    return native_chain::get().db().primary.find(code, scope, table, id);
+}
+
+int32_t db_lowerbound_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+    return native_chain::get().db().primary.lowerbound(code, scope, table, id);
+}
+
+int32_t db_upperbound_i64(uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+    return native_chain::get().db().primary.upperbound(code, scope, table, id);
+}
+
+int32_t db_end_i64(uint64_t code, uint64_t scope, uint64_t table) {
+    return native_chain::get().db().primary.end(code, scope, table);
+}
+
+// =============================================================
+// Database, secondary indices
+// =============================================================
+#define NATIVE_SECONDARY_COMMON(IDX)                                                                                   \
+    void db_##IDX##_remove(int32_t iterator) {                                                                         \
+        auto& chain = native_chain::get();                                                                             \
+        chain.db().IDX.remove(chain.ram(), chain.receiver(), iterator);                                                \
+    }                                                                                                                  \
+    int32_t db_##IDX##_next(int32_t iterator, uint64_t* primary) {                                                     \
+        return native_chain::get().db().IDX.next(iterator, primary);                                                   \
+    }                                                                                                                  \
+    int32_t db_##IDX##_previous(int32_t iterator, uint64_t* primary) {                                                 \
+        return native_chain::get().db().IDX.previous(iterator, primary);                                               \
+    }                                                                                                                  \
+    int32_t db_##IDX##_end(uint64_t code, uint64_t scope, uint64_t table) {                                            \
+        return native_chain::get().db().IDX.end(code, scope, table);                                                   \
+    }
+
+#define NATIVE_SECONDARY_SIMPLE(IDX, TYPE)                                                                             \
+    NATIVE_SECONDARY_COMMON(IDX)                                                                                       \
+    int32_t db_##IDX##_store(uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const TYPE* secondary) {     \
+        auto& chain = native_chain::get();                                                                             \
+        return chain.db().IDX.store(chain.ram(), chain.receiver(), scope, table, payer, id, *secondary);               \
+    }                                                                                                                  \
+    void db_##IDX##_update(int32_t iterator, uint64_t payer, const TYPE* secondary) {                                  \
+        auto& chain = native_chain::get();                                                                             \
+        chain.db().IDX.update(chain.ram(), chain.receiver(), iterator, payer, *secondary);                             \
+    }                                                                                                                  \
+    int32_t db_##IDX##_find_primary(                                                                                   \
+        uint64_t code, uint64_t scope, uint64_t table, TYPE* secondary, uint64_t primary) {                            \
+        return native_chain::get().db().IDX.find_primary(code, scope, table, secondary, primary);                      \
+    }                                                                                                                  \
+    int32_t db_##IDX##_find_secondary(                                                                                 \
+        uint64_t code, uint64_t scope, uint64_t table, const TYPE* secondary, uint64_t* primary) {                     \
+        return native_chain::get().db().IDX.find_secondary(code, scope, table, secondary, primary);                    \
+    }                                                                                                                  \
+    int32_t db_##IDX##_lowerbound(uint64_t code, uint64_t scope, uint64_t table, TYPE* secondary, uint64_t* primary) { \
+        return native_chain::get().db().IDX.lowerbound(code, scope, table, secondary, primary);                        \
+    }                                                                                                                  \
+    int32_t db_##IDX##_upperbound(uint64_t code, uint64_t scope, uint64_t table, TYPE* secondary, uint64_t* primary) { \
+        return native_chain::get().db().IDX.upperbound(code, scope, table, secondary, primary);                        \
+    }
+
+NATIVE_SECONDARY_SIMPLE(idx64, uint64_t)
+NATIVE_SECONDARY_SIMPLE(idx128, unsigned __int128)
+NATIVE_SECONDARY_SIMPLE(idx_double, double)
+NATIVE_SECONDARY_SIMPLE(idx_long_double, long double)
+
+/* 256-bit keys are passed as array of two 128-bit words */
+NATIVE_SECONDARY_COMMON(idx256)
+
+static game_sim::key256 to_key256(const unsigned __int128* data, uint32_t data_len) {
+    game_sim::check(data_len == 2u, "invalid size of secondary key array for idx256");
+    return game_sim::key256{data[0], data[1]};
+}
+
+static void from_key256(const game_sim::key256& key, unsigned __int128* data) {
+    data[0] = key[0];
+    data[1] = key[1];
+}
+
+int32_t db_idx256_store(
+    uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const unsigned __int128* data, uint32_t data_len) {
+    auto& chain = native_chain::get();
+    return chain.db().idx256.store(chain.ram(), chain.receiver(), scope, table, payer, id, to_key256(data, data_len));
+}
+
+void db_idx256_update(int32_t iterator, uint64_t payer, const unsigned __int128* data, uint32_t data_len) {
+    auto& chain = native_chain::get();
+    chain.db().idx256.update(chain.ram(), chain.receiver(), iterator, payer, to_key256(data, data_len));
+}
+
+int32_t db_idx256_find_primary(
+    uint64_t code, uint64_t scope, uint64_t table, unsigned __int128* data, uint32_t data_len, uint64_t primary) {
+    auto key = to_key256(data, data_len);
+    const auto itr = native_chain::get().db().idx256.find_primary(code, scope, table, &key, primary);
+    from_key256(key, data);
+    return itr;
+}
+
+int32_t db_idx256_find_secondary(
+    uint64_t code, uint64_t scope, uint64_t table, const unsigned __int128* data, uint32_t data_len, uint64_t* primary) {
+    const auto key = to_key256(data, data_len);
+    return native_chain::get().db().idx256.find_secondary(code, scope, table, &key, primary);
+}
+
+int32_t db_idx256_lowerbound(
+    uint64_t code, uint64_t scope, uint64_t table, unsigned __int128* data, uint32_t data_len, uint64_t* primary) {
+    auto key = to_key256(data, data_len);
+    const auto itr = native_chain::get().db().idx256.lowerbound(code, scope, table, &key, primary);
+    from_key256(key, data);
+    return itr;
+}
+
+int32_t db_idx256_upperbound(
+    uint64_t code, uint64_t scope, uint64_t table, unsigned __int128* data, uint32_t data_len, uint64_t* primary) {
+    auto key = to_key256(data, data_len);
+    const auto itr = native_chain::get().db().idx256.upperbound(code, scope, table, &key, primary);
+    from_key256(key, data);
+    return itr;
+}
+
+} // extern "C"
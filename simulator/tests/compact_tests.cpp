@@ -0,0 +1,69 @@
+#define BOOST_TEST_MODULE compact_tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <game-contract-sdk/compact.hpp>
+
+#include <game_simulator/native_chain.hpp>
+
+#include <random>
+
+using namespace service::compact;
+
+BOOST_AUTO_TEST_SUITE(compact_tests)
+
+BOOST_AUTO_TEST_CASE(varint_format_test) {
+    const auto out = encode_varints({0, 127, 128, 300});
+    const bytes expected = {0x11, 4, 0, 127, char(0x80), 1, char(0xac), 2};
+    BOOST_CHECK_EQUAL_COLLECTIONS(out.begin(), out.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(bitpacked_format_test) {
+    // die faces: 3 bits each, LSB first
+    const auto out = encode_bitpacked({1, 6, 3}, 3);
+    const bytes expected = {0x12, 3, 3, char(0b11110001), 0b0};
+    BOOST_CHECK_EQUAL_COLLECTIONS(out.begin(), out.end(), expected.begin(), expected.end());
+
+    BOOST_REQUIRE_THROW(encode_bitpacked({8}, 3), game_sim::assert_error);
+    BOOST_REQUIRE_THROW(encode_bitpacked({1}, 0), game_sim::assert_error);
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_test) {
+    std::mt19937_64 rng(42);
+    for (int i = 0; i != 10000; ++i) {
+        const auto bits = uint8_t(1 + rng() % 64);
+        std::vector<uint64_t> values(rng() % 64);
+        for (auto& value : values) {
+            value = bits == 64 ? rng() : rng() & ((uint64_t(1) << bits) - 1);
+        }
+
+        BOOST_REQUIRE(decode(encode_varints(values)) == values);
+        BOOST_REQUIRE(decode(encode_bitpacked(values, bits)) == values);
+        BOOST_REQUIRE(decode(encode(values)) == values);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(smaller_encoding_test) {
+    // 52 card indices: 6 bits against 8 bits of varints and 64 bits of default packing
+    std::vector<uint64_t> deck(52);
+    for (size_t i = 0; i != deck.size(); ++i) {
+        deck[i] = i;
+    }
+    const auto out = encode(deck);
+    BOOST_REQUIRE_EQUAL(uint8_t(out[0]), header(kind::bitpacked));
+    BOOST_REQUIRE_EQUAL(out.size(), 3u + 39u);
+
+    const auto large = encode({uint64_t(1) << 60, 1});
+    BOOST_REQUIRE_EQUAL(uint8_t(large[0]), header(kind::varint));
+}
+
+BOOST_AUTO_TEST_CASE(malformed_payload_test) {
+    BOOST_REQUIRE_THROW(decode({}), game_sim::assert_error);
+    BOOST_REQUIRE_THROW(decode({0x21, 0}), game_sim::assert_error);       // unknown version
+    BOOST_REQUIRE_THROW(decode({0x11, 2, 1}), game_sim::assert_error);    // truncated
+    BOOST_REQUIRE_THROW(decode({0x11, 1, 1, 1}), game_sim::assert_error); // trailing bytes
+    BOOST_REQUIRE_THROW(decode({0x11, 1, char(0x80)}), game_sim::assert_error);
+    BOOST_REQUIRE_THROW(decode({0x12, 9, 1, 0}), game_sim::assert_error);
+    BOOST_REQUIRE_THROW(decode({0x12, 1, 65, 0}), game_sim::assert_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+#define BOOST_TEST_MODULE native_db_tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <game_simulator/native_chain.hpp>
+
+namespace game_sim {
+
+constexpr uint64_t code = 1u;
+constexpr uint64_t scope = 2u;
+constexpr uint64_t table = 3u;
+constexpr uint64_t payer = 4u;
+
+struct native_db_fixture {
+    native_db_fixture() { db.ram.set_enabled(true); }
+
+    native_db db;
+};
+
+BOOST_FIXTURE_TEST_SUITE(native_db_tests, native_db_fixture)
+
+BOOST_AUTO_TEST_CASE(primary_iteration_test) {
+    const char data[] = "data";
+    const auto second = db.primary.store(db.ram, code, scope, table, payer, 20, data, 4);
+    const auto first = db.primary.store(db.ram, code, scope, table, payer, 10, data, 2);
+
+    uint64_t primary = 0u;
+    const auto end = db.primary.end(code, scope, table);
+    BOOST_REQUIRE_LT(end, -1);
+    BOOST_REQUIRE_GE(db.primary.previous(end, &primary), 0);
+    BOOST_REQUIRE_EQUAL(primary, 20);
+
+    BOOST_REQUIRE_GE(db.primary.next(first, &primary), 0);
+    BOOST_REQUIRE_EQUAL(primary, 20);
+    BOOST_REQUIRE_EQUAL(db.primary.next(second, &primary), end);
+    BOOST_REQUIRE_EQUAL(db.primary.previous(first, &primary), -1);
+
+    BOOST_REQUIRE_EQUAL(db.primary.get(second, nullptr, 0), 4);
+    BOOST_REQUIRE_THROW(db.primary.store(db.ram, code, scope, table, payer, 10, data, 1), assert_error);
+
+    db.primary.remove(db.ram, code, first);
+    db.primary.remove(db.ram, code, second);
+    BOOST_REQUIRE_EQUAL(db.primary.find(code, scope, table, 10), -1);
+}
+
+BOOST_AUTO_TEST_CASE(secondary_order_test) {
+    db.idx64.store(db.ram, code, scope, table, payer, 1, 50u);
+    db.idx64.store(db.ram, code, scope, table, payer, 2, 40u);
+    db.idx64.store(db.ram, code, scope, table, payer, 3, 50u);
+
+    uint64_t secondary = 45u, primary = 0u;
+    auto itr = db.idx64.lowerbound(code, scope, table, &secondary, &primary);
+    BOOST_REQUIRE_EQUAL(secondary, 50u);
+    BOOST_REQUIRE_EQUAL(primary, 1u);
+
+    db.idx64.next(itr, &primary);
+    BOOST_REQUIRE_EQUAL(primary, 3u);
+
+    secondary = 40u;
+    db.idx64.upperbound(code, scope, table, &secondary, &primary);
+    BOOST_REQUIRE_EQUAL(primary, 1u);
+
+    itr = db.idx64.find_primary(code, scope, table, &secondary, 2);
+    BOOST_REQUIRE_EQUAL(secondary, 40u);
+    db.idx64.update(db.ram, code, itr, 0u, 60u);
+
+    secondary = 60u;
+    BOOST_REQUIRE_GE(db.idx64.find_secondary(code, scope, table, &secondary, &primary), 0);
+    BOOST_REQUIRE_EQUAL(primary, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(ram_billing_test) {
+    const char data[16] = {};
+    const auto itr = db.primary.store(db.ram, code, scope, table, payer, 1, data, sizeof(data));
+    db.idx256.store(db.ram, code, scope, table | 1u, payer, 1, key256{1u, 2u});
+
+    // table + row + data, table + idx256 row
+    BOOST_REQUIRE_EQUAL(db.ram.usage(payer), 108 + 108 + 16 + 108 + 152);
+
+    db.primary.update(db.ram, code, itr, payer + 1, data, 8);
+    BOOST_REQUIRE_EQUAL(db.ram.usage(payer), 108 + 108 + 152);
+    BOOST_REQUIRE_EQUAL(db.ram.usage(payer + 1), 108 + 8);
+
+    db.primary.remove(db.ram, code, itr);
+    BOOST_REQUIRE_EQUAL(db.ram.usage(payer), 108 + 152);
+    BOOST_REQUIRE_EQUAL(db.ram.usage(payer + 1), 0);
+}
+
+BOOST_AUTO_TEST_CASE(undo_test) {
+    const char data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    db.primary.store(db.ram, code, scope, table, payer, 1, data, sizeof(data));
+    db.primary.store(db.ram, code, scope, table, payer, 2, data, 4);
+    db.idx64.store(db.ram, code, scope, table, payer, 1, 10u);
+    db.idx64.store(db.ram, code, scope, table, payer, 2, 20u);
+    const auto ram_before = db.ram.usage(payer);
+
+    db.start_undo();
+    db.primary.update(db.ram, code, db.primary.find(code, scope, table, 1), payer + 1, data, 2);
+    db.primary.remove(db.ram, code, db.primary.find(code, scope, table, 2));
+    db.primary.store(db.ram, code, scope, table, payer, 3, data, 1);
+    db.primary.store(db.ram, code, scope | 1u, table, payer + 1, 1, data, 1);
+
+    uint64_t secondary = 0u;
+    db.idx64.update(db.ram, code, db.idx64.find_primary(code, scope, table, &secondary, 1), 0u, 30u);
+    db.idx64.remove(db.ram, code, db.idx64.find_primary(code, scope, table, &secondary, 2));
+    db.idx64.store(db.ram, code, scope, table, payer, 2, 5u);
+    db.undo();
+
+    char value[8] = {};
+    BOOST_REQUIRE_EQUAL(db.primary.get(db.primary.find(code, scope, table, 1), value, sizeof(value)), 8);
+    BOOST_REQUIRE_EQUAL(value[7], 8);
+    BOOST_REQUIRE_EQUAL(db.primary.get(db.primary.find(code, scope, table, 2), nullptr, 0), 4);
+    BOOST_REQUIRE_LT(db.primary.find(code, scope, table, 3), -1);
+    BOOST_REQUIRE_EQUAL(db.primary.find(code, scope | 1u, table, 1), -1);
+
+    uint64_t primary = 0u;
+    secondary = 0u;
+    db.idx64.lowerbound(code, scope, table, &secondary, &primary);
+    BOOST_REQUIRE_EQUAL(secondary, 10u);
+    BOOST_REQUIRE_EQUAL(primary, 1u);
+    BOOST_REQUIRE_GE(db.idx64.find_primary(code, scope, table, &secondary, 2), 0);
+    BOOST_REQUIRE_EQUAL(secondary, 20u);
+
+    BOOST_REQUIRE_EQUAL(db.ram.usage(payer), ram_before);
+    BOOST_REQUIRE_EQUAL(db.ram.usage(payer + 1), 0);
+
+    // committed changes stay
+    db.start_undo();
+    db.primary.remove(db.ram, code, db.primary.find(code, scope, table, 2));
+    db.commit_undo();
+    db.undo();
+    BOOST_REQUIRE_LT(db.primary.find(code, scope, table, 2), -1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace game_sim
@@ -0,0 +1,73 @@
+#define BOOST_TEST_MODULE payout_math_tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <game-contract-sdk/payout_math.hpp>
+
+#include <game_simulator/native_chain.hpp>
+
+using namespace service::payout_math;
+
+BOOST_AUTO_TEST_SUITE(payout_math_tests)
+
+BOOST_AUTO_TEST_CASE(muldiv_test) {
+    constexpr uint64_t max_amount = (uint64_t(1) << 62) - 1;
+
+    BOOST_REQUIRE_EQUAL(muldiv(7, 3, 2), 10u);
+    BOOST_REQUIRE_EQUAL(muldiv(0, 3, 2), 0u);
+    BOOST_REQUIRE_EQUAL(muldiv(max_amount, max_amount, max_amount), max_amount);
+    BOOST_REQUIRE_EQUAL(muldiv(max_amount, max_amount - 1, max_amount), max_amount - 1);
+    BOOST_REQUIRE_EQUAL(muldiv(UINT64_MAX, UINT64_MAX, UINT64_MAX), UINT64_MAX);
+
+    BOOST_REQUIRE_THROW(muldiv(1, 1, 0), game_sim::assert_error);
+    BOOST_REQUIRE_THROW(muldiv(UINT64_MAX, 2, 1), game_sim::assert_error);
+}
+
+BOOST_AUTO_TEST_CASE(whale_stake_test) {
+    // products of these amounts overflow 64 bits, so checked asset multiplication fails
+    constexpr int64_t deposit = 4000000000000000000;
+    constexpr int64_t bonus_deposit = 1000000000000000000;
+
+    const auto win = settle_win(deposit, bonus_deposit, 3000000000000000000);
+    BOOST_REQUIRE_EQUAL(win.real_win, 2250000000000000000);
+    BOOST_REQUIRE_EQUAL(win.bonus_payout, 1750000000000000000);
+    BOOST_REQUIRE_EQUAL(win.real_refund, 3000000000000000000);
+    BOOST_REQUIRE_EQUAL(win.casino_win, 0);
+
+    const auto loss = settle_loss(deposit, bonus_deposit, 2000000000000000001);
+    BOOST_REQUIRE_EQUAL(loss.bonus_payout, 500000000000000000);
+    BOOST_REQUIRE_EQUAL(loss.real_refund, 1500000000000000001);
+    BOOST_REQUIRE_EQUAL(loss.casino_win, 1499999999999999999);
+}
+
+BOOST_AUTO_TEST_CASE(rounding_and_invariants_test) {
+    for (int64_t deposit = 1; deposit <= 40; ++deposit) {
+        for (int64_t bonus_deposit = 0; bonus_deposit <= deposit; ++bonus_deposit) {
+            for (int64_t payout = 0; payout <= deposit; ++payout) {
+                const auto result = settle_loss(deposit, bonus_deposit, payout);
+                // bonus share is rounded down like former asset arithmetic
+                BOOST_REQUIRE_EQUAL(result.bonus_payout, payout * bonus_deposit / deposit);
+                BOOST_REQUIRE_EQUAL(result.real_refund + result.bonus_payout, payout);
+                BOOST_REQUIRE_EQUAL(result.real_refund + result.casino_win, deposit - bonus_deposit);
+                BOOST_REQUIRE_GE(result.casino_win, 0);
+                BOOST_REQUIRE_EQUAL(result.real_win, 0);
+            }
+            for (int64_t win = 1; win <= 3 * deposit; ++win) {
+                const auto result = settle_win(deposit, bonus_deposit, win);
+                BOOST_REQUIRE_EQUAL(result.bonus_payout - bonus_deposit, win * bonus_deposit / deposit);
+                BOOST_REQUIRE_EQUAL(result.real_win + result.bonus_payout - bonus_deposit, win);
+                BOOST_REQUIRE_EQUAL(result.real_payout(), deposit - bonus_deposit + result.real_win);
+                BOOST_REQUIRE_EQUAL(result.casino_win, 0);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(invalid_amounts_test) {
+    BOOST_REQUIRE_THROW(settle_loss(0, 0, 0), game_sim::assert_error);
+    BOOST_REQUIRE_THROW(settle_loss(10, 11, 0), game_sim::assert_error);
+    BOOST_REQUIRE_THROW(settle_loss(10, 5, 11), game_sim::assert_error);
+    BOOST_REQUIRE_THROW(settle_loss(10, 5, -1), game_sim::assert_error);
+    BOOST_REQUIRE_THROW(settle_win(10, 5, 0), game_sim::assert_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
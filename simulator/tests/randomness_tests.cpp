@@ -0,0 +1,307 @@
+#define BOOST_TEST_MODULE randomness_tests
+#include <boost/test/included/unit_test.hpp>
+
+#include <game-contract-sdk/service.hpp>
+#include <game_simulator/explorer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <thread>
+
+/*
+ Statistical tests of SDK randomness: ShaMixWithRejection, shuffle, cut_to and uniform.
+ Samples are produced from many seeds on all cores, every seed gives fixed size chunk of samples.
+ Number of samples per test is taken from `RANDOMNESS_SAMPLES` environment variable,
+ default is enough for regular runs, certification runs use billions.
+*/
+
+namespace {
+
+constexpr uint64_t chunk_size = 1u << 14; // samples per seed
+
+uint64_t samples_count() {
+    const auto* env = std::getenv("RANDOMNESS_SAMPLES");
+    return env ? std::stoull(env) : 1u << 20;
+}
+
+eosio::checksum256 seed_digest(uint64_t seed) {
+    return eosio::sha256(reinterpret_cast<const char*>(&seed), sizeof(seed));
+}
+
+/* runs `sampler(acc, seed, count)` for all chunks on all cores, merges per thread accumulators */
+template <typename Acc, typename Sampler> Acc parallel_reduce(uint64_t samples, const Acc& init, Sampler&& sampler) {
+    const auto workers = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<Acc> results(workers, init);
+    std::vector<std::exception_ptr> errors(workers);
+    std::atomic<uint64_t> next_chunk{0u};
+    std::vector<std::thread> threads;
+
+    for (uint32_t worker = 0; worker != workers; ++worker) {
+        threads.emplace_back([&, worker]() {
+            try {
+                for (auto chunk = next_chunk++; chunk * chunk_size < samples; chunk = next_chunk++) {
+                    sampler(results[worker], chunk, std::min(chunk_size, samples - chunk * chunk_size));
+                }
+            } catch (...) {
+                errors[worker] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    auto result = init;
+    for (const auto& acc : results) {
+        result.merge(acc);
+    }
+    return result;
+}
+
+struct histogram {
+    std::vector<uint64_t> counts;
+
+    void merge(const histogram& other) {
+        for (size_t i = 0; i != counts.size(); ++i) {
+            counts[i] += other.counts[i];
+        }
+    }
+
+    uint64_t total() const { return std::accumulate(counts.begin(), counts.end(), uint64_t(0)); }
+
+    /* chi-square statistic against uniform distribution, normalized to standard normal (Wilson-Hilferty) */
+    double uniformity_z() const {
+        const double expected = double(total()) / counts.size();
+        double chi_square = 0.;
+        for (const auto count : counts) {
+            chi_square += (count - expected) * (count - expected) / expected;
+        }
+        const double dof = counts.size() - 1;
+        return (std::cbrt(chi_square / dof) - (1. - 2. / (9. * dof))) / std::sqrt(2. / (9. * dof));
+    }
+};
+
+/* sums for Pearson correlation of consecutive samples */
+struct serial_sums {
+    long double n{0}, x{0}, y{0}, xx{0}, yy{0}, xy{0};
+
+    void add(long double a, long double b) {
+        n += 1;
+        x += a;
+        y += b;
+        xx += a * a;
+        yy += b * b;
+        xy += a * b;
+    }
+
+    void merge(const serial_sums& other) {
+        n += other.n;
+        x += other.x;
+        y += other.y;
+        xx += other.xx;
+        yy += other.yy;
+        xy += other.xy;
+    }
+
+    double correlation() const {
+        return double((n * xy - x * y) / std::sqrt((n * xx - x * x) * (n * yy - y * y)));
+    }
+};
+
+// p-value of z = 5 is ~3e-7, seeds are fixed, so failure means real bias
+constexpr double max_z = 5.;
+
+eosio::checksum256 random_digest(std::mt19937_64& rng) {
+    return eosio::checksum256(std::array<uint64_t, 4>{rng(), rng(), rng(), rng()});
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(randomness_tests)
+
+BOOST_AUTO_TEST_CASE(prng_range_chi_square_test) {
+    for (const uint64_t range : {2u, 6u, 37u, 100u, 1000u}) {
+        const auto sampler = [&](auto& acc, uint64_t seed, uint64_t count) {
+            service::ShaMixWithRejection prng(seed_digest(seed));
+            for (uint64_t i = 0; i != count; ++i) {
+                acc.counts[prng.next(0, range)]++;
+            }
+        };
+        const auto result = parallel_reduce(samples_count(), histogram{std::vector<uint64_t>(range)}, sampler);
+
+        BOOST_TEST_MESSAGE("ShaMixWithRejection range " << range << ": z = " << result.uniformity_z());
+        BOOST_REQUIRE_LT(result.uniformity_z(), max_z);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(prng_serial_correlation_test) {
+    constexpr uint64_t range = uint64_t(1) << 32;
+
+    const auto result = parallel_reduce(samples_count(), serial_sums{}, [&](auto& acc, uint64_t seed, uint64_t count) {
+        service::ShaMixWithRejection prng(seed_digest(seed));
+        auto prev = prng.next(0, range);
+        for (uint64_t i = 0; i != count; ++i) {
+            const auto next = prng.next(0, range);
+            acc.add(prev, next);
+            prev = next;
+        }
+    });
+
+    // correlation of independent samples is normal with deviation 1/sqrt(n)
+    const auto z = std::abs(result.correlation()) * std::sqrt(double(result.n));
+    BOOST_TEST_MESSAGE("ShaMixWithRejection serial correlation: " << result.correlation() << ", z = " << z);
+    BOOST_REQUIRE_LT(z, max_z);
+}
+
+BOOST_AUTO_TEST_CASE(shuffle_permutation_uniformity_test) {
+    constexpr size_t size = 5u; // 120 permutations
+    constexpr size_t permutations = 120u;
+
+    const auto sampler = [&](auto& acc, uint64_t seed, uint64_t count) {
+        service::PRNG::Ptr prng = std::make_shared<service::ShaMixWithRejection>(seed_digest(seed));
+        std::array<int, size> items;
+        for (uint64_t i = 0; i != count; ++i) {
+            std::iota(items.begin(), items.end(), 0);
+            service::shuffle(items.begin(), items.end(), prng);
+
+            // Lehmer code of permutation
+            size_t index = 0;
+            for (size_t j = 0; j != size; ++j) {
+                const auto smaller_after =
+                    std::count_if(items.begin() + j + 1, items.end(), [&](int item) { return item < items[j]; });
+                index = index * (size - j) + smaller_after;
+            }
+            acc.counts[index]++;
+        }
+    };
+    // every shuffle takes several PRNG calls, so less samples are taken
+    const auto result = parallel_reduce(samples_count() / 4, histogram{std::vector<uint64_t>(permutations)}, sampler);
+
+    BOOST_TEST_MESSAGE("shuffle of " << size << " items: z = " << result.uniformity_z());
+    BOOST_REQUIRE_LT(result.uniformity_z(), max_z);
+}
+
+BOOST_AUTO_TEST_CASE(cut_to_bias_report_test) {
+    // `cut_to<uint32_t>` output is uniform on [0, 2^32 - 2], so `% n` favours residues below 2^32 - 1 mod n
+    constexpr uint64_t modulus = std::numeric_limits<uint32_t>::max();
+    for (const uint64_t n : {2u, 6u, 37u, 100u, 1000u, 1000000u, 3u << 30}) {
+        const auto quotient = modulus / n;
+        const auto favoured = modulus % n;
+        BOOST_TEST_MESSAGE("cut_to<uint32_t> % " << n << ": " << favoured << " residues have relative bias "
+                                                  << (favoured ? 1. / quotient : 0.));
+    }
+
+    // small ranges: bias is far below statistical noise
+    for (const uint64_t range : {2u, 6u, 37u, 100u}) {
+        const auto sampler = [&](auto& acc, uint64_t seed, uint64_t count) {
+            std::mt19937_64 rng(seed);
+            for (uint64_t i = 0; i != count; ++i) {
+                acc.counts[service::cut_to<uint32_t>(random_digest(rng)) % range]++;
+            }
+        };
+        const auto result = parallel_reduce(samples_count(), histogram{std::vector<uint64_t>(range)}, sampler);
+        BOOST_TEST_MESSAGE("cut_to<uint32_t> % " << range << ": z = " << result.uniformity_z());
+        BOOST_REQUIRE_LT(result.uniformity_z(), max_z);
+    }
+
+    // large range: residues below 2^32 - 1 - n are twice as likely, bias is measurable
+    constexpr uint64_t large_range = 3u << 30;
+    constexpr uint64_t favoured = modulus - large_range;
+    const auto sampler = [&](auto& acc, uint64_t seed, uint64_t count) {
+        std::mt19937_64 rng(seed);
+        for (uint64_t i = 0; i != count; ++i) {
+            acc.counts[service::cut_to<uint32_t>(random_digest(rng)) % large_range < favoured ? 1 : 0]++;
+        }
+    };
+    const auto result = parallel_reduce(samples_count(), histogram{std::vector<uint64_t>(2)}, sampler);
+
+    const auto observed = double(result.counts[1]) / result.total();
+    const auto fair = double(favoured) / large_range;
+    const auto expected = 2. * favoured / modulus;
+    BOOST_TEST_MESSAGE("cut_to<uint32_t> % " << large_range << ": P(residue < " << favoured << ") = " << observed
+                                              << ", fair " << fair << ", expected " << expected);
+    BOOST_REQUIRE_LT(std::abs(observed - expected), max_z * std::sqrt(expected * (1. - expected) / result.total()));
+}
+
+BOOST_AUTO_TEST_CASE(uniform_chi_square_test) {
+    for (const uint64_t range : {2u, 6u, 37u, 100u, 1000u}) {
+        const auto sampler = [&](auto& acc, uint64_t seed, uint64_t count) {
+            std::mt19937_64 rng(seed);
+            for (uint64_t i = 0; i != count; ++i) {
+                acc.counts[service::uniform(random_digest(rng), range)]++;
+            }
+        };
+        const auto result = parallel_reduce(samples_count(), histogram{std::vector<uint64_t>(range)}, sampler);
+        BOOST_TEST_MESSAGE("uniform range " << range << ": z = " << result.uniformity_z());
+        BOOST_REQUIRE_LT(result.uniformity_z(), max_z);
+    }
+
+    const auto sampler = [&](auto& acc, uint64_t seed, uint64_t count) {
+        std::mt19937_64 rng(seed);
+        for (uint64_t i = 0; i != count; ++i) {
+            acc.counts[service::uniform<100>(random_digest(rng))]++;
+        }
+    };
+    const auto result = parallel_reduce(samples_count(), histogram{std::vector<uint64_t>(100)}, sampler);
+    BOOST_TEST_MESSAGE("uniform<100>: z = " << result.uniformity_z());
+    BOOST_REQUIRE_LT(result.uniformity_z(), max_z);
+}
+
+BOOST_AUTO_TEST_CASE(uniform_large_range_test) {
+    // the range `cut_to<uint32_t>` is visibly biased on
+    constexpr uint64_t large_range = 3u << 30;
+    constexpr uint64_t favoured = std::numeric_limits<uint32_t>::max() - large_range;
+    const auto sampler = [&](auto& acc, uint64_t seed, uint64_t count) {
+        std::mt19937_64 rng(seed);
+        for (uint64_t i = 0; i != count; ++i) {
+            acc.counts[service::uniform<large_range>(random_digest(rng)) < favoured ? 1 : 0]++;
+        }
+    };
+    const auto result = parallel_reduce(samples_count(), histogram{std::vector<uint64_t>(2)}, sampler);
+
+    const auto observed = double(result.counts[1]) / result.total();
+    const auto fair = double(favoured) / large_range;
+    BOOST_TEST_MESSAGE("uniform<" << large_range << ">: P(value < " << favoured << ") = " << observed << ", fair "
+                                  << fair);
+    BOOST_REQUIRE_LT(std::abs(observed - fair), max_z * std::sqrt(fair * (1. - fair) / result.total()));
+}
+
+BOOST_AUTO_TEST_CASE(uniform_rejection_test) {
+    // n = 3: low parts below 2^64 mod 3 = 1 are rejected, i.e. word 0 only, next word is taken
+    BOOST_REQUIRE_EQUAL(service::uniform(eosio::checksum256(std::array<uint64_t, 4>{0u, ~0ull, 0u, 0u}), 3u), 2u);
+    BOOST_REQUIRE_EQUAL(service::uniform<3>(eosio::checksum256(std::array<uint64_t, 4>{0u, 0u, ~0ull, 0u})), 2u);
+    // powers of two are never rejected
+    BOOST_REQUIRE_EQUAL(service::uniform<4>(eosio::checksum256(std::array<uint64_t, 4>{0u, ~0ull, 0u, 0u})), 0u);
+
+    for (const uint64_t n : {1u, 2u, 3u, 100u, 1000u}) {
+        for (uint64_t value = 0; value != n; ++value) {
+            BOOST_REQUIRE_EQUAL(service::uniform(game_sim::uniform_digest(value, n), n), value);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(random_buckets_test) {
+    const auto uniform = game_sim::uniform_buckets(3u);
+    BOOST_REQUIRE_EQUAL(uniform.size(), 3u);
+    for (uint64_t value = 0; value != uniform.size(); ++value) {
+        BOOST_REQUIRE_EQUAL(service::uniform(uniform[value].digest, 3u), value);
+        BOOST_REQUIRE_EQUAL(double(uniform[value].probability), 1. / 3.);
+    }
+
+    const auto cut_to = game_sim::cut_to_buckets(2u);
+    BOOST_REQUIRE_EQUAL(cut_to.size(), 2u);
+    for (uint64_t value = 0; value != cut_to.size(); ++value) {
+        BOOST_REQUIRE_EQUAL(service::cut_to<uint64_t>(cut_to[value].digest), value);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
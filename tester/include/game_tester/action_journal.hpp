@@ -0,0 +1,288 @@
+#pragma once
+
+#include <eosio/chain/action.hpp>
+#include <eosio/chain/name.hpp>
+#include <eosio/chain/trace.hpp>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/reflect/reflect.hpp>
+
+#include <game_tester/resource_profiler.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* fails test when replayed journal has different results or mean CPU of any action grew more than `percent` */
+#define BOOST_REQUIRE_JOURNAL_MATCH(diff, percent)                                                                     \
+    {                                                                                                                  \
+        for (const auto& mismatch : (diff).mismatches) {                                                               \
+            BOOST_ERROR(mismatch.to_string());                                                                         \
+        }                                                                                                              \
+        for (const auto& regression : (diff).cpu_regressions(percent)) {                                               \
+            BOOST_ERROR(regression);                                                                                   \
+        }                                                                                                              \
+        BOOST_REQUIRE_MESSAGE((diff).replayed > 0, "no journaled transactions are replayed");                          \
+        BOOST_REQUIRE_MESSAGE((diff).mismatches.empty(), "replayed journal results differ");                           \
+        BOOST_REQUIRE_MESSAGE((diff).cpu_regressions(percent).empty(), "replayed journal CPU regressed");              \
+    }
+
+namespace testing {
+
+/*
+ Journal records:
+    segment     - start of test body, following records with its id are replayed on fresh fixture
+    player      - `create_player` call, accounts created otherwise aren't journaled
+    link        - `link_game` call
+    transaction - transaction pushed by tester with its result, events and resources
+*/
+enum class journal_record : uint8_t {
+    segment = 1,
+    player = 2,
+    link = 3,
+    transaction = 4,
+};
+
+struct journal_segment {
+    uint32_t id;
+    std::string name;
+};
+
+struct journal_player {
+    uint32_t segment;
+    eosio::chain::name player;
+};
+
+struct journal_link {
+    uint32_t segment;
+    eosio::chain::name player;
+    eosio::chain::name game;
+};
+
+struct journal_transaction {
+    uint32_t segment;
+    int64_t time_offset_us; // head block time since segment start
+    std::vector<eosio::chain::permission_level> signers;
+    std::vector<eosio::chain::action> actions;
+    std::string error; // empty on success
+    std::vector<std::pair<uint32_t, std::vector<char>>> events; // type, data
+    resource_sample usage; // totals of all action traces
+};
+
+/* args of `sgdicefirst` and `sgdicesecond` */
+struct signidice_args {
+    uint64_t req_id;
+    std::string sign;
+};
+
+inline resource_sample transaction_usage(const eosio::chain::transaction_trace& trace) {
+    resource_sample usage;
+    usage.cpu_us = trace.receipt ? trace.receipt->cpu_usage_us : 0;
+    usage.net_bytes = trace.net_usage;
+    for (const auto& action_trace : trace.action_traces) {
+        usage.elapsed_us += action_trace.elapsed.count();
+        for (const auto& ram_delta : action_trace.account_ram_deltas) {
+            usage.ram_bytes += ram_delta.delta;
+        }
+    }
+    return usage;
+}
+
+/**
+   Binary journal of transactions pushed by testers, written for later replay against new contract or SDK build.
+   File is magic followed by records `kind (1 byte) | size (4 bytes) | fc::raw packed record`.
+   Journal is shared by testers of whole test run when `GAME_TESTER_JOURNAL` environment variable is set,
+   every Boost fixture test body is recorded as its own segment.
+*/
+class action_journal {
+  public:
+    static constexpr const char* record_env = "GAME_TESTER_JOURNAL";
+    static constexpr char magic[4] = {'G', 'T', 'J', '1'};
+
+  public:
+    explicit action_journal(const std::string& path) : _out(path, std::ios::binary | std::ios::trunc) {
+        FC_ASSERT(_out.is_open(), "unable to open journal ${path}", ("path", path));
+        _out.write(magic, sizeof(magic));
+    }
+
+    /* journal of test run, nullptr if recording isn't requested by environment */
+    static action_journal* global() {
+        static action_journal* journal = []() -> action_journal* {
+            const auto* path = std::getenv(record_env);
+            if (path == nullptr || *path == '\0') {
+                return nullptr;
+            }
+            static action_journal instance(path);
+            return &instance;
+        }();
+        return journal;
+    }
+
+    uint32_t begin_segment(const std::string& name) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto id = _segments++;
+        write_record(journal_record::segment, journal_segment{id, name});
+        return id;
+    }
+
+    template <typename Record> void write(journal_record kind, const Record& record) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        write_record(kind, record);
+    }
+
+  private:
+    template <typename Record> void write_record(journal_record kind, const Record& record) {
+        const auto data = fc::raw::pack(record);
+        const auto size = static_cast<uint32_t>(data.size());
+
+        _out.put(static_cast<char>(kind));
+        _out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        _out.write(data.data(), data.size());
+    }
+
+  private:
+    std::mutex _mutex;
+    std::ofstream _out;
+    uint32_t _segments{0u};
+};
+
+/**
+   Memory-mapped journal, records are indexed by segment on open and unpacked on access.
+*/
+class journal_reader {
+  public:
+    struct record {
+        journal_record kind;
+        const char* data;
+        uint32_t size;
+    };
+
+    struct segment {
+        std::string name;
+        std::vector<record> records;
+    };
+
+  public:
+    explicit journal_reader(const std::string& path)
+        : _file(path.c_str(), boost::interprocess::read_only), _region(_file, boost::interprocess::read_only) {
+        const auto* pos = static_cast<const char*>(_region.get_address());
+        const auto* end = pos + _region.get_size();
+
+        FC_ASSERT(size_t(end - pos) >= sizeof(action_journal::magic) &&
+                      std::memcmp(pos, action_journal::magic, sizeof(action_journal::magic)) == 0,
+                  "${path} isn't game tester journal", ("path", path));
+        pos += sizeof(action_journal::magic);
+
+        std::map<uint32_t, size_t> segment_index; // id -> position in `_segments`
+        while (pos != end) {
+            uint32_t size;
+            FC_ASSERT(size_t(end - pos) >= 1 + sizeof(size), "truncated journal record");
+            const auto kind = static_cast<journal_record>(*pos);
+            std::memcpy(&size, pos + 1, sizeof(size));
+            pos += 1 + sizeof(size);
+            FC_ASSERT(size_t(end - pos) >= size, "truncated journal record");
+
+            const record rec{kind, pos, size};
+            pos += size;
+
+            if (kind == journal_record::segment) {
+                auto info = get<journal_segment>(rec);
+                segment_index[info.id] = _segments.size();
+                _segments.push_back(segment{std::move(info.name), {}});
+                continue;
+            }
+
+            // every record starts with id of its segment
+            uint32_t segment_id;
+            FC_ASSERT(size >= sizeof(segment_id), "malformed journal record");
+            std::memcpy(&segment_id, rec.data, sizeof(segment_id));
+            const auto it = segment_index.find(segment_id);
+            FC_ASSERT(it != segment_index.end(), "journal record of unknown segment ${id}", ("id", segment_id));
+            _segments[it->second].records.push_back(rec);
+        }
+    }
+
+    const std::vector<segment>& segments() const { return _segments; }
+
+    template <typename Record> static Record get(const record& rec) {
+        fc::datastream<const char*> ds(rec.data, rec.size);
+        Record result;
+        fc::raw::unpack(ds, result);
+        return result;
+    }
+
+  private:
+    boost::interprocess::file_mapping _file;
+    boost::interprocess::mapped_region _region;
+    std::vector<segment> _segments;
+};
+
+/* different outcome of replayed transaction */
+struct journal_mismatch {
+    std::string segment;
+    size_t record;
+    std::string action; // contract::action of first transaction action
+    std::string what;
+    std::string expected;
+    std::string actual;
+
+    std::string to_string() const {
+        std::stringstream ss;
+        ss << segment << " #" << record << " " << action << ": " << what << " expected '" << expected << "', got '"
+           << actual << "'";
+        return ss.str();
+    }
+};
+
+/* comparison of replayed journal with recorded one, CPU is compared by elapsed time of action traces */
+struct journal_diff {
+    struct cpu_totals {
+        uint64_t count{0u};
+        int64_t recorded_us{0};
+        int64_t replayed_us{0};
+    };
+
+    uint64_t replayed{0u};
+    std::vector<journal_mismatch> mismatches;
+    std::map<std::string, cpu_totals> cpu_by_action;
+
+    void add_usage(const std::string& action, const resource_sample& recorded, const resource_sample& actual) {
+        auto& totals = cpu_by_action[action];
+        ++totals.count;
+        totals.recorded_us += recorded.elapsed_us;
+        totals.replayed_us += actual.elapsed_us;
+    }
+
+    /* actions which mean CPU grew more than `percent` */
+    std::vector<std::string> cpu_regressions(double percent) const {
+        std::vector<std::string> result;
+        for (const auto& [action, totals] : cpu_by_action) {
+            if (totals.replayed_us > totals.recorded_us * (1. + percent / 100.)) {
+                std::stringstream ss;
+                ss << action << " cpu " << totals.replayed_us / totals.count << "us, recorded "
+                   << totals.recorded_us / totals.count << "us (" << totals.count << " samples)";
+                result.push_back(ss.str());
+            }
+        }
+        return result;
+    }
+};
+
+} // namespace testing
+
+FC_REFLECT(testing::resource_sample, (elapsed_us)(cpu_us)(net_bytes)(ram_bytes))
+FC_REFLECT(testing::journal_segment, (id)(name))
+FC_REFLECT(testing::journal_player, (segment)(player))
+FC_REFLECT(testing::journal_link, (segment)(player)(game))
+FC_REFLECT(testing::journal_transaction, (segment)(time_offset_us)(signers)(actions)(error)(events)(usage))
+FC_REFLECT(testing::signidice_args, (req_id)(sign))
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <fc/exception/exception.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/*
+ Decoder of compact event payloads encoded by `service::compact` of game SDK,
+ format is described there and in events abi.
+*/
+
+namespace testing::compact {
+
+static constexpr uint8_t varint_header = 0x11;    // version 1, LEB128 varints
+static constexpr uint8_t bitpacked_header = 0x12; // version 1, fixed bit width values
+
+namespace detail {
+inline uint64_t get_varint(const std::vector<char>& in, size_t& pos) {
+    uint64_t value = 0;
+    for (uint32_t shift = 0;; shift += 7) {
+        FC_ASSERT(pos < in.size() && shift < 64, "malformed compact varint");
+        const auto byte = uint8_t(in[pos++]);
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+}
+} // namespace detail
+
+inline std::vector<uint64_t> decode(const std::vector<char>& in) {
+    FC_ASSERT(!in.empty(), "empty compact payload");
+
+    size_t pos = 1;
+    const auto count = detail::get_varint(in, pos);
+    std::vector<uint64_t> values;
+
+    switch (uint8_t(in[0])) {
+    case varint_header:
+        FC_ASSERT(count <= in.size() - pos, "malformed compact payload");
+        values.reserve(count);
+        for (uint64_t i = 0; i != count; ++i) {
+            values.push_back(detail::get_varint(in, pos));
+        }
+        break;
+    case bitpacked_header: {
+        FC_ASSERT(pos < in.size(), "malformed compact payload");
+        const auto bits = uint32_t(uint8_t(in[pos++]));
+        FC_ASSERT(bits >= 1 && bits <= 64, "malformed compact payload");
+        FC_ASSERT(count <= (in.size() - pos) * 8 / bits, "malformed compact payload");
+        const auto mask = bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+
+        values.reserve(count);
+        unsigned __int128 acc = 0;
+        uint32_t filled = 0;
+        for (uint64_t i = 0; i != count; ++i) {
+            for (; filled < bits; filled += 8) {
+                acc |= (unsigned __int128)(uint8_t(in[pos++])) << filled;
+            }
+            values.push_back(uint64_t(acc) & mask);
+            acc >>= bits;
+            filled -= bits;
+        }
+        break;
+    }
+    default:
+        FC_THROW("unknown compact payload header ${header}", ("header", uint32_t(uint8_t(in[0]))));
+    }
+
+    FC_ASSERT(pos == in.size(), "malformed compact payload");
+    return values;
+}
+
+} // namespace testing::compact
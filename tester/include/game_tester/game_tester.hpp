@@ -6,11 +6,16 @@
 #include <boost/test/unit_test.hpp>
 
 #include <eosio/chain/abi_serializer.hpp>
+#include <eosio/chain/contract_table_objects.hpp>
 #include <eosio/chain/exceptions.hpp>
 #include <eosio/chain/resource_limits.hpp>
 #include <eosio/testing/tester.hpp>
 
+#include <game_tester/action_journal.hpp>
 #include <game_tester/contracts.hpp>
+#include <game_tester/game_types.hpp>
+#include <game_tester/resource_profiler.hpp>
+#include <game_tester/rsa_key_pool.hpp>
 #include <game_tester/test_symbol.hpp>
 
 #include <openssl/bio.h>
@@ -21,6 +26,7 @@
 #include <fc/log/logger.hpp>
 #include <fc/variant_object.hpp>
 
+#include <array>
 #include <fstream>
 #include <stdlib.h>
 
@@ -60,25 +66,19 @@ using bytes = std::vector<char>;
 using game_params_type = std::vector<std::pair<uint16_t, uint64_t>>;
 using param_t = uint64_t;
 
-using RSA_ptr = std::unique_ptr<RSA, decltype(&::RSA_free)>;
-using BIO_ptr = std::unique_ptr<BIO, decltype(&::BIO_free)>;
 using EVP_PKEY_ptr = std::unique_ptr<EVP_PKEY, decltype(&::EVP_PKEY_free)>;
 
 namespace testing {
 
-enum struct events_id {
-    game_started = 0,
-    action_request = 1,
-    signidice_part_1_request = 2,
-    signidice_part_2_request = 3,
-    game_finished = 4,
-    game_failed = 5,
-    game_message = 6
-};
-
 // just random account to sign actions that doesn't require auth(e.g signidice)
 static const eosio::chain::name service_name = N(service);
 
+// slots of deterministic rsa keys in `rsa_key_pool`
+enum struct rsa_slot : uint32_t {
+    platform = 0,
+    casino = 1,
+};
+
 class game_tester : public TESTER {
   public:
     constexpr static uint32_t game_session_ttl = 60 * 10;
@@ -87,7 +87,10 @@ class game_tester : public TESTER {
   public:
     game_tester() {
         produce_blocks(2);
-        RAND_set_rand_method(random_mock::RAND_stdlib());
+        {
+            std::lock_guard<std::mutex> lock(random_mock::rand_method_mutex());
+            RAND_set_rand_method(random_mock::RAND_stdlib());
+        }
         create_accounts({platform_name, events_name, casino_name, service_name});
 
         produce_blocks(100);
@@ -98,8 +101,7 @@ class game_tester : public TESTER {
 
         produce_blocks(2);
 
-        auto pl_key = new_rsa_keys();
-        rsa_keys.insert(std::make_pair(platform_name, std::move(pl_key)));
+        rsa_keys.insert(std::make_pair(platform_name, new_rsa_keys(rsa_slot::platform)));
         push_action(platform_name,
                     N(setrsakey),
                     platform_name,
@@ -110,7 +112,7 @@ class game_tester : public TESTER {
 
         push_action(platform_name, N(addcas), platform_name, mvo()("contract", casino_name)("meta", bytes()));
 
-        rsa_keys.insert(std::make_pair(casino_name, new_rsa_keys()));
+        rsa_keys.insert(std::make_pair(casino_name, new_rsa_keys(rsa_slot::casino)));
         push_action(platform_name,
                     N(setrsacas),
                     platform_name,
@@ -122,8 +124,7 @@ class game_tester : public TESTER {
 
         set_authority(platform_name, N(gameaction), {get_public_key(platform_name, "gameaction")}, N(active));
 
-        const auto platform_abi_def = fc::json::from_file(contracts::platform::events::abi_path()).as<abi_def>();
-        _platform_abi_ser = abi_serializer(platform_abi_def, abi_serializer_max_time);
+        game_events::for_each([this](auto* event) { add_event_decoder<std::remove_pointer_t<decltype(event)>>(); });
     }
 
     template <typename Contract> void deploy_contract(account_name account) {
@@ -167,6 +168,7 @@ class game_tester : public TESTER {
     }
 
     std::optional<std::vector<fc::variant>> get_events(const events_id event_id) {
+        decode_events();
         if (auto it = _events.find(event_id); it != _events.end()) {
             return {it->second};
         } else {
@@ -188,7 +190,10 @@ class game_tester : public TESTER {
         return push_action(std::move(act), actor);
     }
 
-    const std::unordered_map<events_id, std::vector<fc::variant>>& get_events_map() const { return _events; }
+    const std::unordered_map<events_id, std::vector<fc::variant>>& get_events_map() const {
+        decode_events();
+        return _events;
+    }
 
     action_result push_action(action&& act, uint64_t authorizer) {
         signed_transaction trx;
@@ -196,21 +201,14 @@ class game_tester : public TESTER {
             act.authorization = vector<permission_level>{{account_name(authorizer), config::active_name}};
         }
         trx.actions.emplace_back(std::move(act));
-        set_transaction_headers(trx);
+        set_batch_transaction_headers(trx);
+        std::vector<permission_level> signers;
         if (authorizer) {
+            signers.push_back({account_name(authorizer), config::active_name});
             trx.sign(get_private_key(account_name(authorizer), "active"), control->get_chain_id());
         }
 
-        try {
-            handle_transaction_ptr(push_transaction(trx));
-        } catch (const fc::exception& ex) {
-            edump((ex.to_detail_string()));
-            return error(ex.top_message()); // top_message() is assumed by many tests; otherwise they fail
-                                            // return error(ex.to_detail_string());
-        }
-        produce_block();
-        BOOST_REQUIRE_EQUAL(true, chain_has_transaction(trx.id()));
-        return success();
+        return push_signed_transaction(trx, signers);
     }
 
     action_result push_action(const action_name& contract,
@@ -232,19 +230,10 @@ class game_tester : public TESTER {
 
         signed_transaction trx;
         trx.actions.emplace_back(std::move(act));
-        set_transaction_headers(trx);
+        set_batch_transaction_headers(trx);
         trx.sign(get_private_key(key.actor, key.permission.to_string()), control->get_chain_id());
 
-        try {
-            handle_transaction_ptr(push_transaction(trx));
-        } catch (const fc::exception& ex) {
-            edump((ex.to_detail_string()));
-            return error(ex.top_message()); // top_message() is assumed by many
-                                            // tests; otherwise they fail
-        }
-        produce_block();
-        BOOST_REQUIRE_EQUAL(true, chain_has_transaction(trx.id()));
-        return success();
+        return push_signed_transaction(trx, {key});
     }
 
     action_result push_action(const action_name& contract,
@@ -254,6 +243,113 @@ class game_tester : public TESTER {
         return push_action(contract, name, auth, auth, data);
     }
 
+    /*
+     Block batching: by default every pushed transaction is followed by its own block,
+     with `txs_per_block` > 1 transactions are queued into the pending block and block
+     is produced only when batch is full or on `produce_pending_block()` call.
+     Events are still captured per transaction.
+     Batch is clamped to transactions which fit block CPU limit, see `max_block_batch_size()`.
+    */
+    void set_block_batch_size(uint32_t txs_per_block) {
+        FC_ASSERT(txs_per_block > 0, "block batch size should be positive");
+        _block_batch_size = std::min(txs_per_block, max_block_batch_size());
+
+        if (_pending_trxs.size() >= _block_batch_size) {
+            produce_pending_block();
+        }
+    }
+
+    uint32_t get_block_batch_size() const { return _block_batch_size; }
+
+    /* every transaction pushed by tester is billed `DEFAULT_BILLED_CPU_TIME_US`, one slot is left for onblock */
+    uint32_t max_block_batch_size() const {
+        const auto max_block_cpu = control->get_global_properties().configuration.max_block_cpu_usage;
+        const auto max_txs = static_cast<uint32_t>(max_block_cpu / DEFAULT_BILLED_CPU_TIME_US);
+        return max_txs > 1u ? max_txs - 1u : 1u;
+    }
+
+    /*
+     Resource profiling: every pushed transaction is recorded to attached profiler.
+     By default testers are attached to profiler of test run, see `resource_profiler::global()`.
+    */
+    void set_profiler(resource_profiler* profiler) { _profiler = profiler; }
+
+    resource_profiler* get_profiler() const { return _profiler; }
+
+    /*
+     Action journal: while segment is open every pushed transaction is recorded to attached journal
+     together with `create_player` and `link_game` calls. By default testers are attached to journal
+     of test run, see `action_journal::global()`, and Boost fixture test body is recorded as segment.
+     Segment is replayed by `replay_journal` on fresh tester of the same fixture.
+    */
+    void set_journal(action_journal* journal) {
+        _journal = journal;
+        _journal_segment.reset();
+    }
+
+    action_journal* get_journal() const { return _journal; }
+
+    void begin_journal_segment(const std::string& name) {
+        BOOST_REQUIRE(_journal != nullptr);
+        _journal_segment = _journal->begin_segment(name);
+        _journal_start = control->head_block_time();
+    }
+
+    // called by Boost.Test after fixture construction, so setup of fixture isn't journaled
+    void setup() {
+        if (_journal) {
+            begin_journal_segment(boost::unit_test::framework::current_test_case().full_name());
+        }
+    }
+
+    /* replays recorded segment on this tester and adds differences to `diff` */
+    void replay_journal_segment(const journal_reader::segment& segment, journal_diff& diff) {
+        set_journal(nullptr);
+        _journal_start = control->head_block_time();
+        _journal_replay = true;
+
+        for (size_t i = 0; i != segment.records.size(); ++i) {
+            const auto& record = segment.records[i];
+            switch (record.kind) {
+            case journal_record::player:
+                create_player(journal_reader::get<journal_player>(record).player);
+                break;
+            case journal_record::link: {
+                const auto link = journal_reader::get<journal_link>(record);
+                link_game(link.player, link.game);
+                break;
+            }
+            case journal_record::transaction:
+                replay_journal_transaction(segment.name, i, journal_reader::get<journal_transaction>(record), diff);
+                break;
+            default:
+                BOOST_TEST_FAIL("Unknown journal record");
+            }
+        }
+        _journal_replay = false;
+    }
+
+    void produce_pending_block() {
+        if (_pending_trxs.empty()) {
+            return;
+        }
+
+        // block could be already produced directly by test (e.g. to move time forward)
+        const auto all_included = std::all_of(_pending_trxs.begin(), _pending_trxs.end(), [&](const auto& id) {
+            return chain_has_transaction(id);
+        });
+        if (!all_included) {
+            produce_block();
+        }
+
+        // FC_ASSERT instead of Boost assertion, blocks are produced by worker threads of parallel executor too
+        for (const auto& id : _pending_trxs) {
+            FC_ASSERT(chain_has_transaction(id), "pending transaction ${id} isn't included in block", ("id", id));
+        }
+        _pending_trxs.clear();
+    }
+
+    // fresh random key, generated on every call
     RSA_ptr new_rsa_keys() {
         static bool init = true;
         if (init) {
@@ -261,14 +357,19 @@ class game_tester : public TESTER {
             init = false;
         }
 
+        std::lock_guard<std::mutex> lock(random_mock::rand_method_mutex());
         auto rsa = RSA_ptr(RSA_generate_key(2048, 65537, NULL, NULL), ::RSA_free);
         return rsa;
     }
 
+    // deterministic key from the process-wide pool, generated once per seed
+    RSA_ptr new_rsa_keys(rsa_slot slot) { return rsa_key_pool::instance().get(static_cast<uint32_t>(slot)); }
+
     std::string rsa_sign(const RSA_ptr& rsa, const sha256& digest) {
         bytes signature;
         signature.resize(RSA_size(rsa.get()));
         uint32_t len;
+        std::lock_guard<std::mutex> lock(random_mock::rand_method_mutex()); // blinding takes RAND bytes
         RSA_sign(NID_sha256, (uint8_t*)digest.data(), 32, (unsigned char*)signature.data(), &len, rsa.get());
         return fc::base64_encode(signature.data(), signature.size());
     }
@@ -330,11 +431,19 @@ class game_tester : public TESTER {
         // create gaming permission (allow platform perform game action for
         // player account)
         set_authority(player_name, N(game), {{platform_name, N(active)}}, N(active));
+
+        if (_journal_segment) {
+            _journal->write(journal_record::player, journal_player{*_journal_segment, player_name});
+        }
     }
 
     void link_game(name player_name, name game_name) {
         // allow player to play 'game_name' game
         link_authority(player_name, game_name, N(game));
+
+        if (_journal_segment) {
+            _journal->write(journal_record::link, journal_link{*_journal_segment, player_name, game_name});
+        }
     }
 
     uint64_t get_next_game_id() {
@@ -346,12 +455,18 @@ class game_tester : public TESTER {
                 .as<uint64_t>();
     }
 
+    // thread local to allow independent testers in parallel threads
+    static uint64_t& session_seq() {
+        thread_local static uint64_t ses_id{0u};
+        return ses_id;
+    }
+
     uint64_t new_game_session(name game_name,
                               name player,
                               uint64_t casino_id,
                               asset deposit,
                               const action_result& result = success()) {
-        static uint64_t ses_id{0u};
+        auto& ses_id = session_seq();
 
         BOOST_REQUIRE_EQUAL(
             push_action(get_token_contract(deposit.get_symbol()),
@@ -381,7 +496,7 @@ class game_tester : public TESTER {
                               const action_result& result = success()) {
         BOOST_TEST((real.get_amount() > 0 || bonus.get_amount() > 0), "real or bonus should be greater than 0");
 
-        static uint64_t ses_id{0u};
+        auto& ses_id = session_seq();
 
         if (real.get_amount() > 0) {
             BOOST_REQUIRE_EQUAL(
@@ -421,7 +536,7 @@ class game_tester : public TESTER {
                      std::vector<param_t> params,
                      asset deposit = STRSYM("0"),
                      const action_result& result = success()) {
-        auto player = get_game_session(game_name, ses_id)["player"].as<name>();
+        const auto player = require_session(game_name, ses_id).player;
 
         if (deposit.get_amount() > 0) {
             transfer(player, game_name, deposit, std::to_string(ses_id));
@@ -445,7 +560,7 @@ class game_tester : public TESTER {
                      asset real,
                      asset bonus,
                      const action_result& result = success()) {
-        auto player = get_game_session(game_name, ses_id)["player"].as<name>();
+        const auto player = require_session(game_name, ses_id).player;
 
         if (real.get_amount() > 0) {
             transfer(player, game_name, real, std::to_string(ses_id));
@@ -487,9 +602,14 @@ class game_tester : public TESTER {
 #endif
 
     void signidice(name game_name, uint64_t ses_id) {
-        auto digest = get_game_session(game_name, ses_id)["digest"].as<sha256>();
+        signidice_part_1(game_name, ses_id);
+        signidice_part_2(game_name, ses_id);
+    }
 
-        auto sign_1 = rsa_sign(rsa_keys.at(platform_name), digest);
+    void signidice_part_1(name game_name, uint64_t ses_id) {
+        const auto digest = require_session(game_name, ses_id).digest;
+
+        const auto sign = rsa_sign(rsa_keys.at(platform_name), digest);
         // clang-format off
         BOOST_REQUIRE_EQUAL(
             push_action(
@@ -498,15 +618,17 @@ class game_tester : public TESTER {
                 {service_name, N(active)}, //{platform_name, N(signidice)},
                 mvo()
                     ("req_id", ses_id)
-                    ("sign", sign_1)
+                    ("sign", sign)
             ), success());
         // clang-format on
 
-        BOOST_REQUIRE_EQUAL(get_game_session(game_name, ses_id)["digest"].as<sha256>(), sha256::hash(sign_1));
+        BOOST_REQUIRE_EQUAL(require_session(game_name, ses_id).digest, sha256::hash(sign));
+    }
 
-        digest = get_game_session(game_name, ses_id)["digest"].as<sha256>();
+    void signidice_part_2(name game_name, uint64_t ses_id) {
+        const auto digest = require_session(game_name, ses_id).digest;
 
-        auto sign_2 = rsa_sign(rsa_keys.at(casino_name), digest);
+        const auto sign = rsa_sign(rsa_keys.at(casino_name), digest);
         // clang-format off
         BOOST_REQUIRE_EQUAL(
             push_action(
@@ -515,11 +637,50 @@ class game_tester : public TESTER {
                 {service_name, N(active)}, //{platform_name, N(signidice)},
                 mvo()
                     ("req_id", ses_id)
-                    ("sign", sign_2)
+                    ("sign", sign)
             ), success());
         // clang-format on
     }
 
+    /*
+     Session helpers for worker threads of `strategy::ParallelExecutor`: Boost.Test assertions
+     aren't thread safe, so failed action is thrown as `fc::exception` instead.
+    */
+    uint64_t push_new_game_session(name game_name, name player, uint64_t casino_id, asset deposit) {
+        const auto ses_id = session_seq()++;
+        require_success(transfer(player, game_name, deposit, std::to_string(ses_id)), "deposit");
+        require_success(push_action(game_name,
+                                    N(newgame),
+                                    {platform_name, N(gameaction)},
+                                    mvo()("req_id", ses_id)("casino_id", casino_id)),
+                        "newgame");
+        return ses_id;
+    }
+
+    void push_game_action(name game_name, uint64_t ses_id, uint16_t action_type, std::vector<param_t> params) {
+        require_success(push_action(game_name,
+                                    N(gameaction),
+                                    {platform_name, N(gameaction)},
+                                    mvo()("req_id", ses_id)("type", action_type)("params", params)),
+                        "gameaction");
+    }
+
+    void push_signidice(name game_name, uint64_t ses_id) {
+        const auto first_sign = rsa_sign(rsa_keys.at(platform_name), require_session(game_name, ses_id).digest);
+        require_success(push_action(game_name,
+                                    N(sgdicefirst),
+                                    {service_name, N(active)},
+                                    mvo()("req_id", ses_id)("sign", first_sign)),
+                        "sgdicefirst");
+
+        const auto second_sign = rsa_sign(rsa_keys.at(casino_name), require_session(game_name, ses_id).digest);
+        require_success(push_action(game_name,
+                                    N(sgdicesecond),
+                                    {service_name, N(active)},
+                                    mvo()("req_id", ses_id)("sign", second_sign)),
+                        "sgdicesecond");
+    }
+
     void close_session(name game_name, uint64_t ses_id) {
         // clang-format off
         BOOST_REQUIRE_EQUAL(
@@ -533,6 +694,17 @@ class game_tester : public TESTER {
         // clang-format on
     }
 
+    // number of rows in contract table, read from chain's table index without decoding rows
+    uint64_t get_table_size(name code, name scope, name table) const {
+        const auto* table_id = control->db().find<table_id_object, by_code_scope_table>(
+            boost::make_tuple(code, scope, table));
+        return table_id ? table_id->count : 0u;
+    }
+
+    int64_t get_ram_usage(name account) const {
+        return control->get_resource_limits_manager().get_account_ram_usage(account);
+    }
+
     asset get_balance(name account, symbol sym = symbol{CORE_SYM}) const {
         const auto contract = get_token_contract(sym);
         return get_currency_balance(contract, sym, account); 
@@ -555,6 +727,59 @@ class game_tester : public TESTER {
                             : abi_ser[game_name].binary_to_variant("session_row", data, abi_serializer_max_time);
     }
 
+    // decodes session row directly from binary, much cheaper than `get_game_session`
+    std::optional<session_row> get_session_typed(name game_name, uint64_t ses_id) const {
+        const vector<char> data = get_row_by_account(game_name, game_name, N(session), ses_id);
+        if (data.empty()) {
+            return std::nullopt;
+        }
+        return fc::raw::unpack<session_row>(data);
+    }
+
+    // session which should exist, e.g. for action of running session
+    session_row require_session(name game_name, uint64_t ses_id) const {
+        auto session = get_session_typed(game_name, ses_id);
+        FC_ASSERT(session.has_value(),
+                  "session ${ses_id} of ${game} isn't found",
+                  ("ses_id", ses_id)("game", game_name));
+        return std::move(*session);
+    }
+
+    // params snapshot referenced by session
+    std::optional<params_row> get_session_params(name game_name, uint64_t ses_id) const {
+        const auto session = get_session_typed(game_name, ses_id);
+        if (!session) {
+            return std::nullopt;
+        }
+        const vector<char> data = get_row_by_account(game_name, game_name, N(params), session->params_id);
+        if (data.empty()) {
+            return std::nullopt;
+        }
+        return fc::raw::unpack<params_row>(data);
+    }
+
+    // typed events of last transaction, `Event` is one of `testing::events` structs or registered custom event
+    template <typename Event> std::optional<std::vector<Event>> get_events_typed() const {
+        const auto it = _raw_events.find(static_cast<events_id>(game_sdk::event_type<Event>()));
+        if (it == _raw_events.end()) {
+            return std::nullopt;
+        }
+
+        std::vector<Event> result;
+        result.reserve(it->second.size());
+        for (const auto& data : it->second) {
+            result.emplace_back(data.empty() ? Event{} : fc::raw::unpack<Event>(data));
+        }
+        return result;
+    }
+
+    // game's own event sent by `game::send_event`, `Event` is reflected mirror with the same `type`
+    template <typename Event> void register_event() {
+        static_assert(game_sdk::event_type<Event>() >= game_sdk::first_custom_event_type,
+                      "custom event type should be at least first_custom_event_type");
+        add_event_decoder<Event>();
+    }
+
     void allow_token(const std::string& token_name, uint8_t precision, name contract) {
         create_account(contract);
         deploy_contract<contracts::system::token>(contract);
@@ -588,76 +813,180 @@ class game_tester : public TESTER {
     }
 
   private:
-    const abi_def& get_events_abi(const events_id event_type) {
-        if (_lazy_abi_events.find(event_type) != _lazy_abi_events.end()) {
-            return _lazy_abi_events[event_type];
+    static void require_success(const action_result& result, const char* action) {
+        FC_ASSERT(result == success(), "${action} failed: ${error}", ("action", action)("error", result));
+    }
+
+    void set_batch_transaction_headers(signed_transaction& trx) {
+        // transactions in the same block have the same TaPoS, so shift expiration
+        // to keep ids of identical transactions unique
+        set_transaction_headers(trx, DEFAULT_EXPIRATION_DELTA + static_cast<uint32_t>(_pending_trxs.size()));
+    }
+
+    action_result push_signed_transaction(signed_transaction& trx, const std::vector<permission_level>& signers) {
+        if (_journal_segment || _journal_replay) {
+            _journal_trx.emplace();
+            _journal_trx->segment = _journal_segment.value_or(0u);
+            _journal_trx->time_offset_us = (control->head_block_time() - _journal_start).count();
+            _journal_trx->signers = signers;
+            _journal_trx->actions = trx.actions;
+        }
+
+        try {
+            handle_transaction_ptr(push_transaction(trx));
+        } catch (const fc::exception& ex) {
+            edump((ex.to_detail_string()));
+            if (_journal_trx) {
+                _journal_trx->error = ex.top_message();
+                write_journal_transaction();
+            }
+            return error(ex.top_message()); // top_message() is assumed by many tests; otherwise they fail
+                                            // return error(ex.to_detail_string());
         }
+        write_journal_transaction();
 
-        fc::path event_abi = fc::canonical(events_struct::folder());
+        _pending_trxs.push_back(trx.id());
+        if (_pending_trxs.size() >= _block_batch_size) {
+            produce_pending_block();
+        }
+        return success();
+    }
 
-        switch (event_type) {
-        case events_id::game_started:
-            event_abi /= "game_started.abi";
-            break;
-        case events_id::action_request:
-            event_abi /= "action_request.abi";
-            break;
-        case events_id::signidice_part_1_request:
-            event_abi /= "signidice_part_1_request.abi";
-            break;
-        case events_id::signidice_part_2_request:
-            event_abi /= "signidice_part_2_request.abi";
-            break;
-        case events_id::game_finished:
-            event_abi /= "game_finished.abi";
-            break;
-        case events_id::game_failed:
-            event_abi /= "game_failed.abi";
-            break;
-        case events_id::game_message:
-            event_abi /= "game_message.abi";
-            break;
-        default:
-            BOOST_TEST_FAIL("Can't interpret event type");
+    void write_journal_transaction() {
+        if (_journal_segment && _journal_trx) {
+            _journal->write(journal_record::transaction, *_journal_trx);
+            _journal_trx.reset();
+        }
+    }
+
+    void replay_journal_transaction(const std::string& segment,
+                                    size_t index,
+                                    const journal_transaction& recorded,
+                                    journal_diff& diff) {
+        // blocks are produced to reach recorded time, e.g. for session expiration
+        while (control->head_block_time() - _journal_start < fc::microseconds(recorded.time_offset_us)) {
+            produce_block();
+        }
+
+        signed_transaction trx;
+        trx.actions = recorded.actions;
+        // failed signidice is replayed with recorded sign, e.g. invalid sign test
+        if (recorded.error.empty()) {
+            for (auto& act : trx.actions) {
+                resign_signidice(act);
+            }
+        }
+        set_batch_transaction_headers(trx);
+        for (const auto& signer : recorded.signers) {
+            trx.sign(get_private_key(signer.actor, signer.permission.to_string()), control->get_chain_id());
         }
 
-        _lazy_abi_events[event_type] = fc::json::from_file(event_abi).as<abi_def>();
+        push_signed_transaction(trx, recorded.signers);
+        const auto replayed = std::move(*_journal_trx);
+        _journal_trx.reset();
+
+        const auto action = recorded.actions.empty()
+                                ? std::string()
+                                : recorded.actions[0].account.to_string() + "::" + recorded.actions[0].name.to_string();
+        const auto mismatch = [&](const char* what, std::string expected, std::string actual) {
+            diff.mismatches.push_back({segment, index, action, what, std::move(expected), std::move(actual)});
+        };
+
+        ++diff.replayed;
+        if (replayed.error != recorded.error) {
+            mismatch("result", recorded.error, replayed.error);
+        } else if (replayed.events != recorded.events) {
+            mismatch("events", fc::json::to_string(recorded.events), fc::json::to_string(replayed.events));
+        }
+        if (recorded.error.empty() && replayed.error.empty()) {
+            diff.add_usage(action, recorded.usage, replayed.usage);
+        }
+    }
 
-        return _lazy_abi_events[event_type];
+    // signs depend on session digest, so signidice is signed again for replayed contract
+    void resign_signidice(action& act) {
+        if (act.name != N(sgdicefirst) && act.name != N(sgdicesecond)) {
+            return;
+        }
+        auto args = fc::raw::unpack<signidice_args>(act.data);
+        const auto session = get_session_typed(act.account, args.req_id);
+        if (!session) {
+            return;
+        }
+        const auto signer = act.name == N(sgdicefirst) ? platform_name : casino_name;
+        args.sign = rsa_sign(rsa_keys.at(signer), session->digest);
+        act.data = fc::raw::pack(args);
     }
 
-    void handle_action_data(bytes&& action_data, const events_id event_type) {
-        fc::variant event_struct;
-        if (!action_data.empty()) {
-            abi_serializer abi_ser(get_events_abi(event_type), abi_serializer_max_time);
+    using event_decoder = fc::variant (*)(const bytes&);
 
-            event_struct = abi_ser.binary_to_variant("event_data", action_data, abi_serializer_max_time);
+    template <typename Event> static fc::variant decode_event(const bytes& data) {
+        fc::variant result;
+        fc::to_variant(fc::raw::unpack<Event>(data), result);
+        return result;
+    }
+
+    template <typename Event> void add_event_decoder() {
+        static_assert(game_sdk::event_type<Event>() < game_sdk::max_event_type,
+                      "event type should be below max_event_type");
+        _event_decoders[game_sdk::event_type<Event>()] = &decode_event<Event>;
+    }
+
+    event_decoder get_event_decoder(const events_id event_type) const {
+        const auto type = static_cast<uint32_t>(event_type);
+        if (type >= _event_decoders.size() || !_event_decoders[type]) {
+            BOOST_TEST_FAIL("Can't interpret event type");
         }
+        return _event_decoders[type];
+    }
 
-        if (auto it = _events.find(event_type); it != _events.end()) {
-            it->second.emplace_back(std::move(event_struct));
-        } else {
-            _events[event_type] = {
-                event_struct,
-            };
+    // variant representation is built lazily, only for tests which inspect events
+    void decode_events() const {
+        if (_events_decoded) {
+            return;
+        }
+
+        _events.clear();
+        for (const auto& [event_type, raw_events] : _raw_events) {
+            const auto decode = get_event_decoder(event_type);
+            auto& events = _events[event_type];
+            events.reserve(raw_events.size());
+
+            for (const auto& data : raw_events) {
+                events.emplace_back(data.empty() ? fc::variant() : decode(data));
+            }
         }
+        _events_decoded = true;
+    }
+
+    void handle_action_data(bytes&& action_data, const events_id event_type) {
+        _raw_events[event_type].emplace_back(std::move(action_data));
     }
 
     void handle_transaction_ptr(const transaction_trace_ptr& transaction_trace) {
-        _events.clear();
+        _raw_events.clear();
+        _events_decoded = false;
 
-        std::for_each(transaction_trace->action_traces.begin(),
-                      transaction_trace->action_traces.end(),
-                      [&](const auto& action_trace) {
-                          if (action_trace.receiver != "events" || action_trace.act.name != "send")
-                              return;
+        if (_profiler) {
+            _profiler->record(*transaction_trace);
+        }
+        if (_journal_trx) {
+            _journal_trx->usage = transaction_usage(*transaction_trace);
+        }
 
-                          const fc::variant send_action = _platform_abi_ser.binary_to_variant(
-                              "send", action_trace.act.data, abi_serializer_max_time);
+        for (const auto& action_trace : transaction_trace->action_traces) {
+            if (action_trace.receiver != events_name || action_trace.act.name != N(send)) {
+                continue;
+            }
 
-                          handle_action_data(send_action["data"].as<bytes>(),
-                                             static_cast<events_id>(send_action["event_type"].as<int>()));
-                      });
+            // fixed layout of `send` args, unpack directly without abi
+            auto send_args = fc::raw::unpack<event_send_args>(action_trace.act.data);
+            if (_journal_trx) {
+                _journal_trx->events.emplace_back(send_args.event_type, send_args.data);
+            }
+
+            handle_action_data(std::move(send_args.data), static_cast<events_id>(send_args.event_type));
+        }
     }
 
   public:
@@ -665,11 +994,37 @@ class game_tester : public TESTER {
     std::map<account_name, RSA_ptr> rsa_keys;
 
   private:
-    std::unordered_map<events_id, std::vector<fc::variant>> _events;
-    std::unordered_map<events_id, abi_def> _lazy_abi_events;
-    abi_serializer _platform_abi_ser;
+    std::unordered_map<events_id, std::vector<bytes>> _raw_events;
+    mutable std::unordered_map<events_id, std::vector<fc::variant>> _events;
+    mutable bool _events_decoded{true};
+    std::array<event_decoder, game_sdk::max_event_type> _event_decoders{}; // indexed by event type
+
+    uint32_t _block_batch_size{1u};
+    std::vector<transaction_id_type> _pending_trxs;
+
+    resource_profiler* _profiler{resource_profiler::global()};
+
+    action_journal* _journal{action_journal::global()};
+    std::optional<uint32_t> _journal_segment; // id of open segment
+    fc::time_point _journal_start;
+    bool _journal_replay{false};
+    std::optional<journal_transaction> _journal_trx; // transaction being recorded or replayed
 };
 
+/* replays journal segments with names starting with `prefix`, each one on fresh `Fixture` */
+template <typename Fixture> journal_diff replay_journal(const std::string& path, const std::string& prefix = "") {
+    const journal_reader journal(path);
+    journal_diff diff;
+    for (const auto& segment : journal.segments()) {
+        if (segment.name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        Fixture tester;
+        tester.replay_journal_segment(segment, diff);
+    }
+    return diff;
+}
+
 } // namespace testing
 
 void translate_fc_exception(const fc::exception& e) {
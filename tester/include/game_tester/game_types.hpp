@@ -0,0 +1,168 @@
+#pragma once
+
+#include <eosio/chain/asset.hpp>
+#include <eosio/chain/name.hpp>
+
+#include <fc/crypto/sha256.hpp>
+#include <fc/reflect/reflect.hpp>
+#include <fc/time.hpp>
+
+#include <game-contract-sdk/event_registry.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ Native mirrors of game contract structures.
+ Layouts follow `game_sdk::game` definitions field by field, so rows and events
+ can be decoded with `fc::raw::unpack` without abi and fc::variant.
+*/
+
+namespace testing {
+
+enum struct events_id {
+    game_started = 0,
+    action_request = 1,
+    signidice_part_1_request = 2,
+    signidice_part_2_request = 3,
+    game_finished = 4,
+    game_failed = 5,
+    game_message = 6,
+    round_finished = 7
+};
+
+// args of `events::send` action, same layout as packed by game contract
+struct event_send_args {
+    eosio::chain::name sender;
+    uint64_t casino_id;
+    uint64_t game_id;
+    uint64_t req_id;
+    uint32_t event_type;
+    std::vector<char> data;
+};
+
+/* game_sdk::game::session_row */
+struct session_row {
+    uint64_t ses_id;
+    uint64_t casino_id;
+    uint64_t ses_seq;
+    eosio::chain::name player;
+    uint8_t state;
+    uint64_t params_id;
+    std::string token;
+    eosio::chain::asset deposit;
+    eosio::chain::asset bonus_deposit;
+    fc::sha256 digest;
+    fc::time_point last_update;
+    eosio::chain::asset last_max_win;
+    bool acted;
+    uint8_t prefetch;
+};
+
+/* game_sdk::game::params_row */
+struct params_row {
+    uint64_t id;
+    uint64_t casino_id;
+    std::string token;
+    std::vector<std::pair<uint16_t, uint64_t>> params;
+    fc::sha256 hash;
+    uint64_t ref_count;
+};
+
+/* game_sdk::game::events */
+namespace events {
+
+struct game_started {
+    static constexpr events_id type{events_id::game_started};
+};
+
+struct action_request {
+    static constexpr events_id type{events_id::action_request};
+
+    uint8_t action_type;
+    bool need_deposit;
+};
+
+struct signidice_part_1_request {
+    static constexpr events_id type{events_id::signidice_part_1_request};
+
+    fc::sha256 digest;
+};
+
+struct signidice_part_2_request {
+    static constexpr events_id type{events_id::signidice_part_2_request};
+
+    fc::sha256 digest;
+};
+
+struct game_finished {
+    static constexpr events_id type{events_id::game_finished};
+
+    eosio::chain::asset player_win_amount;
+    std::vector<char> msg;
+};
+
+struct game_failed {
+    static constexpr events_id type{events_id::game_failed};
+
+    eosio::chain::asset player_win_amount;
+    std::vector<char> msg;
+};
+
+struct game_message {
+    static constexpr events_id type{events_id::game_message};
+
+    std::vector<char> msg;
+};
+
+struct round_finished {
+    static constexpr events_id type{events_id::round_finished};
+
+    eosio::chain::asset player_win_amount;
+    eosio::chain::asset balance;
+    std::vector<char> msg;
+};
+
+} // namespace events
+
+/* mirror of `game_sdk::game::events::registry`, games add own events by `game_tester::register_event` */
+using game_events = game_sdk::event_registry<events::game_started,
+                                             events::action_request,
+                                             events::signidice_part_1_request,
+                                             events::signidice_part_2_request,
+                                             events::game_finished,
+                                             events::game_failed,
+                                             events::game_message,
+                                             events::round_finished>;
+
+// mirror is kept by hand, pin it to SDK event ids so both sides change together
+static_assert(game_sdk::event_type<events::game_started>() == game_sdk::sdk_event_ids::game_started);
+static_assert(game_sdk::event_type<events::action_request>() == game_sdk::sdk_event_ids::action_request);
+static_assert(game_sdk::event_type<events::signidice_part_1_request>() ==
+              game_sdk::sdk_event_ids::signidice_part_1_request);
+static_assert(game_sdk::event_type<events::signidice_part_2_request>() ==
+              game_sdk::sdk_event_ids::signidice_part_2_request);
+static_assert(game_sdk::event_type<events::game_finished>() == game_sdk::sdk_event_ids::game_finished);
+static_assert(game_sdk::event_type<events::game_failed>() == game_sdk::sdk_event_ids::game_failed);
+static_assert(game_sdk::event_type<events::game_message>() == game_sdk::sdk_event_ids::game_message);
+static_assert(game_sdk::event_type<events::round_finished>() == game_sdk::sdk_event_ids::round_finished);
+static_assert(game_events::size == game_sdk::sdk_event_ids::count, "tester should mirror every SDK event");
+} // namespace testing
+
+FC_REFLECT(testing::event_send_args, (sender)(casino_id)(game_id)(req_id)(event_type)(data))
+
+FC_REFLECT(testing::session_row,
+           (ses_id)(casino_id)(ses_seq)(player)(state)(params_id)(token)(deposit)(bonus_deposit)(digest)(last_update)(
+               last_max_win)(acted)(prefetch))
+
+FC_REFLECT(testing::params_row, (id)(casino_id)(token)(params)(hash)(ref_count))
+
+FC_REFLECT(testing::events::game_started, )
+FC_REFLECT(testing::events::action_request, (action_type)(need_deposit))
+FC_REFLECT(testing::events::signidice_part_1_request, (digest))
+FC_REFLECT(testing::events::signidice_part_2_request, (digest))
+FC_REFLECT(testing::events::game_finished, (player_win_amount)(msg))
+FC_REFLECT(testing::events::game_failed, (player_win_amount)(msg))
+FC_REFLECT(testing::events::game_message, (msg))
+FC_REFLECT(testing::events::round_finished, (player_win_amount)(balance)(msg))
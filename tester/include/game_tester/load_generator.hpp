@@ -0,0 +1,203 @@
+#pragma once
+
+#include <game_tester/game_tester.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace testing::load {
+
+/* player's step of session, brings session from action request to signidice request */
+using play_t = std::function<void(game_tester&, uint64_t ses_id)>;
+
+struct config {
+    uint32_t players{10u};
+    std::vector<uint32_t> levels{1u, 10u, 100u, 1000u}; // live sessions counts at which costs are measured
+    uint32_t probe_sessions{20u};                       // sessions opened and played at every level
+    asset deposit{STRSYM("1.0000")};
+    std::vector<name> game_tables; // game tables to count, scoped by game account
+    uint32_t seed{0u};
+};
+
+/* costs of game contract at some number of live sessions */
+struct scaling_point {
+    uint32_t live_sessions{0u};
+    uint64_t session_rows{0u};
+    std::map<name, uint64_t> game_rows;
+    int64_t game_ram_bytes{0};
+    std::map<std::string, int64_t> cpu_p50; // game action -> elapsed CPU time, billed CPU is constant in tester
+    std::map<std::string, int64_t> cpu_p90;
+};
+
+/**
+   Opens sessions of many players against single game and keeps them alive,
+   at every level of `config.levels` it opens and plays `probe_sessions` more sessions,
+   their actions and signidice parts are interleaved like on live platform.
+   Players and their balances are created by generator, casino should be funded by test.
+*/
+class load_generator {
+  public:
+    load_generator(game_tester& tester, name game_name, play_t play, config cfg)
+        : _tester(tester), _game_name(game_name), _play(std::move(play)), _config(std::move(cfg)),
+          _rng(_config.seed) {}
+
+    std::vector<scaling_point> run() {
+        BOOST_REQUIRE(_config.players > 0);
+        create_players();
+
+        std::vector<scaling_point> result;
+        for (const auto level : _config.levels) {
+            while (_live.size() < level) {
+                open_session();
+            }
+            result.push_back(probe(level));
+        }
+        return result;
+    }
+
+    static void write_csv(const std::vector<scaling_point>& points, const std::string& path) {
+        std::set<name> tables;
+        std::set<std::string> actions;
+        for (const auto& point : points) {
+            for (const auto& [table, rows] : point.game_rows) {
+                tables.insert(table);
+            }
+            for (const auto& [action, cpu] : point.cpu_p50) {
+                actions.insert(action);
+            }
+        }
+
+        std::ofstream out(path);
+        out << "live_sessions,session_rows,game_ram_bytes";
+        for (const auto& table : tables) {
+            out << ',' << table.to_string() << "_rows";
+        }
+        for (const auto& action : actions) {
+            out << ',' << action << "_cpu_p50," << action << "_cpu_p90";
+        }
+        out << '\n';
+
+        for (const auto& point : points) {
+            out << point.live_sessions << ',' << point.session_rows << ',' << point.game_ram_bytes;
+            for (const auto& table : tables) {
+                const auto it = point.game_rows.find(table);
+                out << ',' << (it != point.game_rows.end() ? it->second : 0u);
+            }
+            for (const auto& action : actions) {
+                const auto p50 = point.cpu_p50.find(action);
+                const auto p90 = point.cpu_p90.find(action);
+                out << ',' << (p50 != point.cpu_p50.end() ? p50->second : 0) << ','
+                    << (p90 != point.cpu_p90.end() ? p90->second : 0);
+            }
+            out << '\n';
+        }
+    }
+
+  private:
+    static name player_name(uint32_t index) {
+        static constexpr char alphabet[] = "12345abcdefghijklmnopqrstuvwxyz";
+        std::string suffix;
+        do {
+            suffix += alphabet[index % (sizeof(alphabet) - 1)];
+            index /= sizeof(alphabet) - 1;
+        } while (index > 0);
+        return name("loadplayer" + suffix);
+    }
+
+    void create_players() {
+        const auto& levels = _config.levels;
+        const auto max_level = levels.empty() ? 0u : *std::max_element(levels.begin(), levels.end());
+        const auto sessions = max_level + _config.probe_sessions * uint32_t(levels.size());
+        const auto balance = asset(_config.deposit.get_amount() * (sessions / _config.players + 1u) * 2,
+                                   _config.deposit.get_symbol());
+
+        for (uint32_t i = 0; i != _config.players; ++i) {
+            const auto player = player_name(i);
+            _tester.create_player(player);
+            _tester.link_game(player, _game_name);
+            // twice of deposits to cover deposits made by actions
+            _tester.transfer(N(eosio), player, balance);
+            _players.push_back(player);
+        }
+        _tester.produce_pending_block();
+    }
+
+    uint64_t open_session() {
+        const auto player = _players[_next_player++ % _players.size()];
+        const auto ses_id = _tester.new_game_session(_game_name, player, game_tester::casino_id, _config.deposit);
+        _live.push_back(ses_id);
+        return ses_id;
+    }
+
+    /* opens and plays probe sessions, costs are recorded by own profiler */
+    scaling_point probe(uint32_t level) {
+        scaling_point point;
+        point.live_sessions = level;
+        point.session_rows = _tester.get_table_size(_game_name, _game_name, N(session));
+        for (const auto& table : _config.game_tables) {
+            point.game_rows[table] = _tester.get_table_size(_game_name, _game_name, table);
+        }
+        point.game_ram_bytes = _tester.get_ram_usage(_game_name);
+
+        resource_profiler profiler;
+        auto* previous_profiler = _tester.get_profiler();
+        _tester.set_profiler(&profiler);
+
+        std::vector<uint64_t> probes;
+        for (uint32_t i = 0; i != _config.probe_sessions; ++i) {
+            probes.push_back(open_session());
+        }
+        std::shuffle(probes.begin(), probes.end(), _rng);
+
+        // every step is made for all probe sessions before next one
+        for (const auto ses_id : probes) {
+            _play(_tester, ses_id);
+        }
+        for (const auto ses_id : probes) {
+            _tester.signidice_part_1(_game_name, ses_id);
+        }
+        for (const auto ses_id : probes) {
+            _tester.signidice_part_2(_game_name, ses_id);
+        }
+        _tester.produce_pending_block();
+
+        _tester.set_profiler(previous_profiler);
+
+        // multi round games keep sessions alive
+        _live.erase(std::remove_if(_live.begin(), _live.end(),
+                                   [&](uint64_t ses_id) {
+                                       return std::find(probes.begin(), probes.end(), ses_id) != probes.end() &&
+                                              !_tester.get_session_typed(_game_name, ses_id);
+                                   }),
+                    _live.end());
+
+        // deposit transfer is billed to token contract, so it isn't reported
+        for (const auto action : {"newgame", "gameaction", "sgdicefirst", "sgdicesecond"}) {
+            const auto& samples = profiler.samples(_game_name, action);
+            if (!samples.empty()) {
+                point.cpu_p50[action] = resource_profiler::percentile(samples, &resource_sample::elapsed_us, 50.);
+                point.cpu_p90[action] = resource_profiler::percentile(samples, &resource_sample::elapsed_us, 90.);
+            }
+        }
+        return point;
+    }
+
+  private:
+    game_tester& _tester;
+    const name _game_name;
+    const play_t _play;
+    const config _config;
+    std::mt19937 _rng;
+
+    std::vector<name> _players;
+    uint32_t _next_player{0u};
+    std::vector<uint64_t> _live; // sessions opened by generator and not finished
+};
+
+} // namespace testing::load
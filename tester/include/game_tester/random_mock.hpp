@@ -1,5 +1,10 @@
+#pragma once
+
 #include <openssl/rand.h>
 
+#include <mutex>
+#include <random>
+
 namespace testing::random_mock {
 
 static int stdlib_rand_seed(const void* buf, int num) {
@@ -29,4 +34,30 @@ RAND_METHOD stdlib_rand_meth = {
 // This is a public-scope accessor method for our table.
 RAND_METHOD* RAND_stdlib() { return &stdlib_rand_meth; }
 
+// Reproducible byte stream, used where output should depend only on the seed
+// (e.g. cached RSA keys) and not on the global std::rand() state.
+// Engine is per thread, so RAND calls of other threads don't consume seeded stream.
+inline thread_local std::mt19937_64 seeded_engine;
+
+static int seeded_rand_bytes(unsigned char* buf, int num) {
+    for (int index = 0; index < num; ++index) {
+        buf[index] = seeded_engine() % 256;
+    }
+    return 1;
+}
+
+inline RAND_METHOD seeded_rand_meth = {
+    stdlib_rand_seed, seeded_rand_bytes, stdlib_rand_cleanup, stdlib_rand_add, seeded_rand_bytes, stdlib_rand_status};
+
+inline RAND_METHOD* RAND_seeded(uint64_t seed) {
+    seeded_engine.seed(seed);
+    return &seeded_rand_meth;
+}
+
+// RAND method is global for process, its swaps and RAND consumers of tester are serialized by this mutex
+inline std::mutex& rand_method_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
 } // namespace testing::random_mock
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <eosio/chain/trace.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <vector>
+
+/*
+ fails test when CPU time of `contract::action` at `percent` percentile isn't below `limit_us`,
+ CPU is elapsed time of action trace, billed CPU of tester is fixed `DEFAULT_BILLED_CPU_TIME_US`
+*/
+#define BOOST_REQUIRE_CPU_BELOW(profiler, contract, action, percent, limit_us)                                         \
+    {                                                                                                                  \
+        const auto& samples = (profiler).samples(contract, action);                                                    \
+        BOOST_REQUIRE_MESSAGE(!samples.empty(), "no resource samples for " << (contract) << "::" << (action));         \
+        const auto cpu_us =                                                                                            \
+            testing::resource_profiler::percentile(samples, &testing::resource_sample::elapsed_us, percent);           \
+        BOOST_REQUIRE_MESSAGE(cpu_us < (limit_us),                                                                     \
+                              (contract) << "::" << (action) << " p" << (percent) << " cpu " << cpu_us << "us, limit " \
+                                         << (limit_us) << "us");                                                       \
+    }
+
+namespace testing {
+
+/* resources used by single action, CPU and NET are billed per transaction and attributed to its root action */
+struct resource_sample {
+    int64_t elapsed_us{0}; // measured execution time, use it to compare CPU costs
+    int64_t cpu_us{0};     // billed CPU, constant for transactions pushed by tester
+    int64_t net_bytes{0};
+    int64_t ram_bytes{0}; // sum of accounts RAM deltas
+};
+
+/**
+   Collects resource usage of pushed transactions.
+   Samples are grouped by (receiver, action name) and by (receiver, lifecycle phase) of game session.
+   Profiler is shared by testers of whole test run when `GAME_TESTER_PROFILE` environment variable is set,
+   report is written to its path on exit, in CSV if path ends with `.csv` and in JSON otherwise.
+*/
+class resource_profiler {
+  public:
+    using key_t = std::pair<eosio::chain::name, std::string>; // receiver, action or phase
+    using samples_t = std::vector<resource_sample>;
+
+    static constexpr const char* report_env = "GAME_TESTER_PROFILE";
+
+  public:
+    ~resource_profiler() {
+        if (!_report_path.empty()) {
+            write_report(_report_path);
+        }
+    }
+
+    /* profiler of test run, nullptr if profiling isn't requested by environment */
+    static resource_profiler* global() {
+        static resource_profiler* profiler = []() -> resource_profiler* {
+            const auto* path = std::getenv(report_env);
+            if (path == nullptr || *path == '\0') {
+                return nullptr;
+            }
+            static resource_profiler instance;
+            instance._report_path = path;
+            return &instance;
+        }();
+        return profiler;
+    }
+
+    void record(const eosio::chain::transaction_trace& trace) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        for (const auto& action_trace : trace.action_traces) {
+            resource_sample sample;
+            sample.elapsed_us = action_trace.elapsed.count();
+            for (const auto& ram_delta : action_trace.account_ram_deltas) {
+                sample.ram_bytes += ram_delta.delta;
+            }
+            if (action_trace.action_ordinal.value == 1u) {
+                sample.cpu_us = trace.receipt ? trace.receipt->cpu_usage_us : 0;
+                sample.net_bytes = trace.net_usage;
+            }
+
+            const auto action = action_trace.act.name.to_string();
+            _by_action[key_t{action_trace.receiver, action}].push_back(sample);
+            _by_phase[key_t{action_trace.receiver, phase_of(action)}].push_back(sample);
+        }
+    }
+
+    const samples_t& samples(eosio::chain::name receiver, const std::string& action) const {
+        return find(_by_action, key_t{receiver, action});
+    }
+
+    const samples_t& phase_samples(eosio::chain::name receiver, const std::string& phase) const {
+        return find(_by_phase, key_t{receiver, phase});
+    }
+
+    /* nearest-rank percentile of metric, `percent` in [0, 100] */
+    static int64_t percentile(const samples_t& samples, int64_t resource_sample::*metric, double percent) {
+        if (samples.empty()) {
+            return 0;
+        }
+        std::vector<int64_t> values;
+        values.reserve(samples.size());
+        for (const auto& sample : samples) {
+            values.push_back(sample.*metric);
+        }
+        const auto rank = std::min(values.size() - 1, size_t(std::max(percent, 0.) / 100. * values.size()));
+        std::nth_element(values.begin(), values.begin() + rank, values.end());
+        return values[rank];
+    }
+
+    /* lifecycle phase of game session action */
+    static std::string phase_of(const std::string& action) {
+        static const std::map<std::string, std::string> phases = {
+            {"transfer", "deposit"},
+            {"depositbon", "deposit"},
+            {"newgame", "start"},
+            {"newgamebon", "start"},
+            {"gameaction", "action"},
+            {"sgdicefirst", "signidice"},
+            {"sgdicesecond", "signidice"},
+            {"close", "close"},
+        };
+        const auto it = phases.find(action);
+        return it != phases.end() ? it->second : "other";
+    }
+
+    void merge(const resource_profiler& other) {
+        std::scoped_lock lock(_mutex, other._mutex);
+        for (const auto& [key, samples] : other._by_action) {
+            auto& target = _by_action[key];
+            target.insert(target.end(), samples.begin(), samples.end());
+        }
+        for (const auto& [key, samples] : other._by_phase) {
+            auto& target = _by_phase[key];
+            target.insert(target.end(), samples.begin(), samples.end());
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _by_action.clear();
+        _by_phase.clear();
+    }
+
+    void write_report(const std::string& path) const {
+        const auto is_csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+        is_csv ? write_csv(path) : write_json(path);
+    }
+
+    void write_json(const std::string& path) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const auto groups_to_variant = [](const std::map<key_t, samples_t>& groups, const char* key_name) {
+            fc::variants result;
+            for (const auto& [key, samples] : groups) {
+                fc::mutable_variant_object group;
+                group("receiver", key.first.to_string())(key_name, key.second)("count", samples.size());
+                for (const auto& [metric_name, metric] : metrics()) {
+                    group(metric_name, summary_to_variant(samples, metric));
+                }
+                result.emplace_back(std::move(group));
+            }
+            return result;
+        };
+
+        std::ofstream out(path);
+        out << fc::json::to_pretty_string(fc::mutable_variant_object()("actions", groups_to_variant(_by_action, "action"))(
+                   "phases", groups_to_variant(_by_phase, "phase")))
+            << std::endl;
+    }
+
+    void write_csv(const std::string& path) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        std::ofstream out(path);
+        out << "group,receiver,name,metric,count,mean,p50,p90,p99,max\n";
+
+        const auto write_groups = [&](const std::map<key_t, samples_t>& groups, const char* group_name) {
+            for (const auto& [key, samples] : groups) {
+                for (const auto& [metric_name, metric] : metrics()) {
+                    out << group_name << ',' << key.first.to_string() << ',' << key.second << ',' << metric_name << ','
+                        << samples.size() << ',' << mean(samples, metric);
+                    for (const auto percent : {50., 90., 99., 100.}) {
+                        out << ',' << percentile(samples, metric, percent);
+                    }
+                    out << '\n';
+                }
+            }
+        };
+        write_groups(_by_action, "action");
+        write_groups(_by_phase, "phase");
+    }
+
+  private:
+    static const std::vector<std::pair<const char*, int64_t resource_sample::*>>& metrics() {
+        static const std::vector<std::pair<const char*, int64_t resource_sample::*>> result = {
+            {"elapsed_us", &resource_sample::elapsed_us},
+            {"cpu_us", &resource_sample::cpu_us},
+            {"net_bytes", &resource_sample::net_bytes},
+            {"ram_bytes", &resource_sample::ram_bytes},
+        };
+        return result;
+    }
+
+    static double mean(const samples_t& samples, int64_t resource_sample::*metric) {
+        if (samples.empty()) {
+            return 0.;
+        }
+        const auto sum = std::accumulate(samples.begin(), samples.end(), 0.,
+                                         [&](double acc, const resource_sample& sample) { return acc + sample.*metric; });
+        return sum / samples.size();
+    }
+
+    static fc::mutable_variant_object summary_to_variant(const samples_t& samples, int64_t resource_sample::*metric) {
+        return fc::mutable_variant_object()("mean", mean(samples, metric))("p50", percentile(samples, metric, 50.))(
+            "p90", percentile(samples, metric, 90.))("p99", percentile(samples, metric, 99.))(
+            "max", percentile(samples, metric, 100.));
+    }
+
+    const samples_t& find(const std::map<key_t, samples_t>& groups, const key_t& key) const {
+        static const samples_t empty;
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto it = groups.find(key);
+        return it != groups.end() ? it->second : empty;
+    }
+
+  private:
+    mutable std::mutex _mutex;
+    std::map<key_t, samples_t> _by_action;
+    std::map<key_t, samples_t> _by_phase;
+    std::string _report_path;
+};
+
+} // namespace testing
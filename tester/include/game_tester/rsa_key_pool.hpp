@@ -0,0 +1,149 @@
+#pragma once
+
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/rand.h>
+#include <openssl/rsa.h>
+
+#include <unistd.h>
+
+#include <fc/exception/exception.hpp>
+#include <fc/filesystem.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "random_mock.hpp"
+
+using RSA_ptr = std::unique_ptr<RSA, decltype(&::RSA_free)>;
+using BIO_ptr = std::unique_ptr<BIO, decltype(&::BIO_free)>;
+
+namespace testing {
+
+/**
+   Process-wide pool of deterministic RSA keys.
+   Generating 2048-bit key takes hundreds of milliseconds, so every (seed, slot) pair
+   is generated only once and then handed out as a fresh copy to each fixture.
+   Keys are kept in memory as PEM and optionally mirrored to disk:
+    - GAME_TESTER_RSA_SEED - seed for key generation (default: 0)
+    - GAME_TESTER_RSA_CACHE - directory for PEM cache (disabled if not set)
+*/
+class rsa_key_pool {
+  public:
+    static constexpr int key_bits = 2048;
+    static constexpr unsigned long key_exponent = 65537;
+
+  public:
+    static rsa_key_pool& instance() {
+        static rsa_key_pool pool;
+        return pool;
+    }
+
+    /* returns key for `slot` generated from pool's default seed */
+    RSA_ptr get(uint32_t slot) { return get(_seed, slot); }
+
+    RSA_ptr get(uint64_t seed, uint32_t slot) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const auto key = std::make_pair(seed, slot);
+        auto it = _keys.find(key);
+        if (it == _keys.end()) {
+            it = _keys.emplace(key, load_or_generate(seed, slot)).first;
+        }
+        return from_pem(it->second);
+    }
+
+    uint64_t seed() const { return _seed; }
+
+  private:
+    rsa_key_pool() {
+        ERR_load_crypto_strings();
+
+        if (const char* seed = std::getenv("GAME_TESTER_RSA_SEED")) {
+            _seed = std::stoull(seed);
+        }
+        if (const char* cache_dir = std::getenv("GAME_TESTER_RSA_CACHE")) {
+            _cache_dir = fc::path(cache_dir);
+        }
+    }
+
+    std::string load_or_generate(uint64_t seed, uint32_t slot) const {
+        const auto path = cache_path(seed, slot);
+
+        if (!path.empty() && fc::exists(path)) {
+            std::ifstream in(path.string());
+            std::stringstream ss;
+            ss << in.rdbuf();
+            return ss.str();
+        }
+
+        const auto pem = generate(seed, slot);
+
+        if (!path.empty()) {
+            // cache dir can be shared by parallel test processes, so key file appears only when it's complete
+            fc::create_directories(_cache_dir);
+            const auto tmp_path = path.string() + ".tmp" + std::to_string(::getpid());
+            {
+                std::ofstream out(tmp_path);
+                out << pem;
+                FC_ASSERT(out.good(), "failed to write rsa key to ${path}", ("path", tmp_path));
+            }
+            FC_ASSERT(std::rename(tmp_path.c_str(), path.string().c_str()) == 0,
+                      "failed to move rsa key to ${path}", ("path", path.string()));
+        }
+        return pem;
+    }
+
+    static std::string generate(uint64_t seed, uint32_t slot) {
+        // OpenSSL takes all key material from the RAND method, so with seeded byte stream
+        // the same (seed, slot) always produces the same key
+        std::lock_guard<std::mutex> lock(random_mock::rand_method_mutex());
+        const auto prev_method = RAND_get_rand_method();
+        RAND_set_rand_method(random_mock::RAND_seeded(seed * 0x9e3779b97f4a7c15ull + slot));
+
+        auto rsa = RSA_ptr(RSA_generate_key(key_bits, key_exponent, NULL, NULL), ::RSA_free);
+
+        RAND_set_rand_method(prev_method);
+        FC_ASSERT(rsa, "failed to generate rsa key");
+
+        return to_pem(rsa);
+    }
+
+    static std::string to_pem(const RSA_ptr& rsa) {
+        auto mem = BIO_ptr(BIO_new(BIO_s_mem()), ::BIO_free);
+        PEM_write_bio_RSAPrivateKey(mem.get(), rsa.get(), NULL, NULL, 0, NULL, NULL);
+
+        BUF_MEM* bio_buf;
+        BIO_get_mem_ptr(mem.get(), &bio_buf);
+        return std::string(bio_buf->data, bio_buf->length);
+    }
+
+    static RSA_ptr from_pem(const std::string& pem) {
+        auto mem = BIO_ptr(BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size())), ::BIO_free);
+        auto rsa = RSA_ptr(PEM_read_bio_RSAPrivateKey(mem.get(), NULL, NULL, NULL), ::RSA_free);
+        FC_ASSERT(rsa, "failed to read rsa key from pem");
+        return rsa;
+    }
+
+    fc::path cache_path(uint64_t seed, uint32_t slot) const {
+        if (_cache_dir.empty()) {
+            return fc::path();
+        }
+        return _cache_dir / ("rsa-" + std::to_string(seed) + "-" + std::to_string(slot) + ".pem");
+    }
+
+  private:
+    std::mutex _mutex;
+    std::map<std::pair<uint64_t, uint32_t>, std::string> _keys;
+    uint64_t _seed{0u};
+    fc::path _cache_dir;
+};
+
+} // namespace testing
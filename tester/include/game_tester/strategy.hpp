@@ -2,6 +2,16 @@
 
 #include <game_tester/game_tester.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace testing::strategy {
 
 enum Result {
@@ -39,6 +49,18 @@ class Node {
 
     const action_t& get_action() { return _action; }
 
+    template <typename Func> void for_each_child(Func&& func) const {
+        for (const auto& edge : _children) {
+            func(edge.second);
+        }
+    }
+
+    template <typename Func> void for_each_edge(Func&& func) const {
+        for (const auto& [condition, child] : _children) {
+            func(condition, child);
+        }
+    }
+
   private:
     action_t _action;
 
@@ -49,23 +71,82 @@ class Node {
 struct Graph {
     explicit Graph(action_t&& root_action) : root(std::make_shared<strategy::Node>(std::move(root_action))) {}
 
+    /* all reachable nodes in BFS order, position in vector is stable node index */
+    std::vector<std::shared_ptr<Node>> nodes() const {
+        std::vector<std::shared_ptr<Node>> result{root};
+        std::unordered_set<const Node*> visited{root.get()};
+
+        for (size_t i = 0; i != result.size(); ++i) {
+            result[i]->for_each_child([&](const auto& child) {
+                if (visited.insert(child.get()).second) {
+                    result.push_back(child);
+                }
+            });
+        }
+        return result;
+    }
+
     std::shared_ptr<Node> root;
 };
 
+/* Outcome of single run, reported by session close callback */
+struct Outcome {
+    double bet{0.};
+    double payout{0.};
+};
+
+/* Aggregated statistics of strategy runs */
+struct Stats {
+    uint64_t runs{0u};
+    uint64_t aborted{0u};
+    double total_bet{0.};
+    double total_payout{0.};
+    std::vector<uint64_t> node_hits; // indexed as `Graph::nodes()`
+
+    double rtp() const { return total_bet > 0. ? total_payout / total_bet : 0.; }
+
+    void add(const Outcome& outcome) {
+        total_bet += outcome.bet;
+        total_payout += outcome.payout;
+    }
+
+    void merge(const Stats& other) {
+        runs += other.runs;
+        aborted += other.aborted;
+        total_bet += other.total_bet;
+        total_payout += other.total_payout;
+
+        node_hits.resize(std::max(node_hits.size(), other.node_hits.size()), 0u);
+        for (size_t i = 0; i != other.node_hits.size(); ++i) {
+            node_hits[i] += other.node_hits[i];
+        }
+    }
+};
+
 class Executor {
   public:
-    explicit Executor(Graph&& graph) : _graph(graph) {}
+    using session_create_t = std::function<session_id_t(game_tester&, const uint)>;
+    using session_close_t = std::function<void(game_tester&, const session_id_t)>;
+    using session_outcome_t = std::function<Outcome(game_tester&, const session_id_t)>;
+
+  public:
+    explicit Executor(Graph&& graph) : _graph(graph) {
+        const auto nodes = _graph.nodes();
+        for (size_t i = 0; i != nodes.size(); ++i) {
+            _node_index.emplace(nodes[i].get(), i);
+        }
+    }
 
     uint process_strategy(game_tester& tester,
                           const uint run_count,
                           const uint limit_per_run,
-                          std::function<session_id_t(game_tester&, const uint)>&& session_create,
-                          std::function<void(game_tester&, const session_id_t)>&& session_close) {
+                          session_create_t&& session_create,
+                          session_close_t&& session_close) {
 
         for (uint run = 0; run != run_count; ++run) {
             const auto session_id = session_create(tester, run);
 
-            if (!execute_to_end(tester, _graph.root, session_id, limit_per_run)) {
+            if (!execute_to_end(tester, _graph.root, session_id, limit_per_run, nullptr)) {
                 return run;
             }
 
@@ -79,11 +160,36 @@ class Executor {
         return run_count;
     }
 
+    /* executes single run and collects its statistics, returns false if run was aborted */
+    bool process_run(game_tester& tester,
+                     const uint run,
+                     const uint limit_per_run,
+                     const session_create_t& session_create,
+                     const session_outcome_t& session_close,
+                     Stats& stats) {
+        stats.node_hits.resize(_node_index.size(), 0u);
+
+        const auto session_id = session_create(tester, run);
+
+        stats.runs++;
+        if (!execute_to_end(tester, _graph.root, session_id, limit_per_run, &stats)) {
+            stats.aborted++;
+            return false;
+        }
+
+        stats.add(session_close(tester, session_id));
+        return true;
+    }
+
   private:
-    static bool
-    execute_to_end(game_tester& tester, std::shared_ptr<Node> current, const session_id_t session_id, uint limit) {
+    bool execute_to_end(
+        game_tester& tester, std::shared_ptr<Node> current, const session_id_t session_id, uint limit, Stats* stats) {
 
         while (limit-- != 0) {
+            if (stats != nullptr && current != nullptr) {
+                stats->node_hits[_node_index.at(current.get())]++;
+            }
+
             switch (process_next_step(tester, session_id, current)) {
             case Result::Continue:
                 continue;
@@ -117,5 +223,278 @@ class Executor {
 
   private:
     Graph _graph;
+    std::unordered_map<const Node*, size_t> _node_index;
+};
+
+/**
+   Flattened strategy graph.
+   Nodes are kept in contiguous vector in `Graph::nodes()` order (root is 0), edges of every node
+   are stored contiguously and refer to nodes by index. `Action` and `Condition` can be any callables
+   with strategy signatures, e.g. function pointers or lambdas, to avoid `std::function` type erasure.
+*/
+template <typename Action = action_t, typename Condition = condition_t> class CompiledGraph {
+  public:
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    struct Edge {
+        Condition condition;
+        uint32_t target;
+    };
+
+    struct CompiledNode {
+        Action action;
+        uint32_t first_edge;
+        uint32_t edge_count;
+    };
+
+  public:
+    CompiledGraph() = default;
+
+    /* compiles graph built by `Graph` front-end */
+    explicit CompiledGraph(const Graph& graph) {
+        const auto nodes = graph.nodes();
+
+        std::unordered_map<const Node*, uint32_t> index;
+        for (size_t i = 0; i != nodes.size(); ++i) {
+            index.emplace(nodes[i].get(), uint32_t(i));
+        }
+
+        _nodes.reserve(nodes.size());
+        for (const auto& node : nodes) {
+            auto& compiled = _nodes.emplace_back(CompiledNode{node->get_action(), uint32_t(_edges.size()), 0u});
+            node->for_each_edge([&](const condition_t& condition, const std::shared_ptr<Node>& child) {
+                _edges.push_back(Edge{condition, index.at(child.get())});
+                compiled.edge_count++;
+            });
+        }
+    }
+
+    /* appends node with its out edges, returns node index */
+    uint32_t add_node(Action action, std::vector<Edge> edges = {}) {
+        _nodes.push_back(CompiledNode{std::move(action), uint32_t(_edges.size()), uint32_t(edges.size())});
+        for (auto& edge : edges) {
+            _edges.push_back(std::move(edge));
+        }
+        return uint32_t(_nodes.size() - 1);
+    }
+
+    /* index of first child which condition is satisfied, `npos` if there is no such child */
+    uint32_t traversal(uint32_t node, const game_tester& tester) const {
+        const auto& current = _nodes[node];
+        for (auto edge = current.first_edge, last = edge + current.edge_count; edge != last; ++edge) {
+            if (_edges[edge].condition(tester)) {
+                return _edges[edge].target;
+            }
+        }
+        return npos;
+    }
+
+    const CompiledNode& node(uint32_t index) const { return _nodes[index]; }
+
+    size_t size() const { return _nodes.size(); }
+
+  private:
+    std::vector<CompiledNode> _nodes;
+    std::vector<Edge> _edges;
+};
+
+/* Executor over `CompiledGraph`, same interface and statistics as `Executor` */
+template <typename Action = action_t, typename Condition = condition_t> class CompiledExecutor {
+  public:
+    using graph_t = CompiledGraph<Action, Condition>;
+
+  public:
+    explicit CompiledExecutor(graph_t&& graph) : _graph(std::move(graph)) {}
+    explicit CompiledExecutor(Graph&& graph) : _graph(graph) {}
+
+    uint process_strategy(game_tester& tester,
+                          const uint run_count,
+                          const uint limit_per_run,
+                          Executor::session_create_t&& session_create,
+                          Executor::session_close_t&& session_close) {
+
+        for (uint run = 0; run != run_count; ++run) {
+            const auto session_id = session_create(tester, run);
+
+            if (!execute_to_end(tester, session_id, limit_per_run, nullptr)) {
+                return run;
+            }
+
+            session_close(tester, session_id);
+
+            if (run % 500 == 0) {
+                BOOST_TEST_MESSAGE(run << " rounds passed");
+            }
+        }
+
+        return run_count;
+    }
+
+    bool process_run(game_tester& tester,
+                     const uint run,
+                     const uint limit_per_run,
+                     const Executor::session_create_t& session_create,
+                     const Executor::session_outcome_t& session_close,
+                     Stats& stats) {
+        stats.node_hits.resize(_graph.size(), 0u);
+
+        const auto session_id = session_create(tester, run);
+
+        stats.runs++;
+        if (!execute_to_end(tester, session_id, limit_per_run, &stats)) {
+            stats.aborted++;
+            return false;
+        }
+
+        stats.add(session_close(tester, session_id));
+        return true;
+    }
+
+  private:
+    bool execute_to_end(game_tester& tester, const session_id_t session_id, uint limit, Stats* stats) const {
+        if (_graph.size() == 0) {
+            return false;
+        }
+
+        uint32_t current = 0u;
+        while (limit-- != 0) {
+            if (stats != nullptr) {
+                stats->node_hits[current]++;
+            }
+
+            const auto result = _graph.node(current).action(tester, session_id);
+            if (result != Result::Continue) {
+                return result == Result::End;
+            }
+
+            if (current = _graph.traversal(current, tester); current == graph_t::npos) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+  private:
+    graph_t _graph;
 };
+
+/**
+   Runs strategy on K independent chains, one `Tester` per worker thread.
+   Runs are split into per-worker ranges, idle worker steals half of the largest
+   remaining range, so worker of a run depends on scheduling. Graph of every worker is built
+   over worker's `rng` which is reseeded with `seed + run` before each run: strategy's random
+   choices of a run don't depend on worker, while chain results (e.g. session ids) still may.
+   Callbacks run on worker threads, they should throw instead of using Boost assertions,
+   e.g. use `push_new_game_session`, `push_game_action` and `push_signidice` of `game_tester`.
+   `ExecutorType` is `Executor` or `CompiledExecutor<>`, constructed from `Graph`.
+   Note: wasm runtime of the node should allow independent controllers in different threads.
+*/
+template <typename Tester, typename ExecutorType = Executor> class ParallelExecutor {
+  public:
+    using tester_factory_t = std::function<std::unique_ptr<Tester>(const uint worker, const uint64_t seed)>;
+    using graph_factory_t = std::function<Graph(std::mt19937_64& rng)>;
+    using session_create_t = std::function<session_id_t(Tester&, const uint)>;
+    using session_outcome_t = std::function<Outcome(Tester&, const session_id_t)>;
+
+  public:
+    ParallelExecutor(graph_factory_t&& graph_factory, const uint workers, const uint64_t seed = 0u)
+        : _graph_factory(std::move(graph_factory)), _workers(std::max(workers, 1u)), _seed(seed) {}
+
+    Stats process_strategy(const tester_factory_t& tester_factory,
+                           const uint run_count,
+                           const uint limit_per_run,
+                           const session_create_t& session_create,
+                           const session_outcome_t& session_close) {
+        _ranges.assign(_workers, {0u, 0u});
+        for (uint worker = 0; worker != _workers; ++worker) {
+            _ranges[worker] = {run_count * uint64_t(worker) / _workers, run_count * uint64_t(worker + 1) / _workers};
+        }
+
+        std::vector<Stats> stats(_workers);
+        std::vector<std::exception_ptr> errors(_workers);
+        std::vector<std::thread> threads;
+        std::atomic<uint64_t> passed{0u};
+
+        for (uint worker = 0; worker != _workers; ++worker) {
+            threads.emplace_back([&, worker]() {
+                try {
+                    std::mt19937_64 rng;
+                    auto tester = tester_factory(worker, _seed + worker);
+                    auto executor = ExecutorType(_graph_factory(rng));
+
+                    const Executor::session_create_t create = [&](game_tester& t, const uint run) {
+                        return session_create(static_cast<Tester&>(t), run);
+                    };
+                    const Executor::session_outcome_t close = [&](game_tester& t, const session_id_t ses_id) {
+                        return session_close(static_cast<Tester&>(t), ses_id);
+                    };
+
+                    uint run;
+                    while (next_run(worker, run)) {
+                        rng.seed(_seed + run);
+                        executor.process_run(*tester, run, limit_per_run, create, close, stats[worker]);
+                        ++passed;
+                    }
+                } catch (...) {
+                    errors[worker] = std::current_exception();
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    for (auto& range : _ranges) {
+                        range.first = range.second; // stop other workers
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        // Boost.Test log isn't thread safe, so progress is reported by calling thread only
+        BOOST_TEST_MESSAGE(passed << " rounds passed");
+
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        Stats result;
+        for (const auto& worker_stats : stats) {
+            result.merge(worker_stats);
+        }
+        return result;
+    }
+
+  private:
+    bool next_run(const uint worker, uint& run) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto& own = _ranges[worker];
+        if (own.first == own.second) {
+            // steal upper half of the largest remaining range
+            auto victim = std::max_element(_ranges.begin(), _ranges.end(), [](const auto& l, const auto& r) {
+                return l.second - l.first < r.second - r.first;
+            });
+            if (victim->first == victim->second) {
+                return false;
+            }
+
+            const auto middle = victim->first + (victim->second - victim->first) / 2;
+            own = {middle, victim->second};
+            victim->second = middle;
+        }
+
+        run = uint(own.first++);
+        return true;
+    }
+
+  private:
+    graph_factory_t _graph_factory;
+    uint _workers;
+    uint64_t _seed;
+
+    std::mutex _mutex;
+    std::vector<std::pair<uint64_t, uint64_t>> _ranges;
+};
+
 } // namespace testing::strategy